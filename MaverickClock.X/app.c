@@ -20,18 +20,27 @@
 #include "CRC16bit.h"
 #include "mcc_generated_files/memory.h"
 
+/*********************** Macro Definition(s) *****************/
+/* Called from an ISR to mark its source as needing main loop service */
+#define APP_POST_EVENT(wakeReason) ( appPendingEvents |= (uint8_t) ( 1u << ( wakeReason ) ) )
+
 /********************* Function Prototype(s) *******************/
 static void Timer1Interrupt( void );
+static void App_PostTimeTickEvent( void );
+static void App_PostEncoderEvent( void );
 
 /**************************** Local Variables ******************/
 APP app = {
     .state = DISPLAY_TIME_MODE
 };
 
+static volatile uint8_t appPendingEvents = 0u; // Bit per APP_WAKE_REASON, set by ISRs and cleared by APP_WaitForEvent
+
 static RotaryEncoder rot = {
     .rotBtn.config.multiClickTimerThreshold_cts = 0x54D, // 350 ms equivalent in counts
     .rotBtn.config.longPressTimerThreshold_cts = 0x1E48, // 2s equivalent in counts
     .rotBtn.config.multiClickTimeFreshnessLimit_cts = 0xF24, // 1s equivalent in counts 
+    .shaft.config.isAccelerationEnabled = true,
 };
 
 void APP_Initialize( void )
@@ -74,20 +83,19 @@ void APP_Initialize( void )
                                eepromReadbackData[4],
                                eepromReadbackData[5] );
 
-    /* Prerender all digit values to file static pixel buffers */
+    /* Clear the face to the background palette entry */
     Clock_PrerenderPixelAndBackgroundValues( );
 
     /* Enable time calculation module */
     Time_InitializeTimeModule( );
+    Time_SetTickEventHandler( App_PostTimeTickEvent );
     Time_EnableTimeModule( );
 
     /* Initialize and enable  rotary encoder */
     RotaryEncoder_Init( &rot );
+    RotaryEncoder_SetEventHandler( App_PostEncoderEvent );
     RotaryEncoder_Enable( );
 
-    /* Setup pattern mode function table */
-    State_SetFunctionLookupTable( );
-
     /* Fault out LED timer */
     TMR1_SetInterruptHandler( Timer1Interrupt );
     TMR1_StartTimer( );
@@ -98,11 +106,12 @@ void APP_Initialize( void )
 void APP_TASKS( void )
 {
     static bool wasSwitchPressedInTimeMode = false; // Denotes time mode minutes to hours change. 
+    RotaryButtonEvent buttonEvent;
 
-    /* Update state machine if encoder button is pressed */
-    if( RotaryEncoder_HasButtonPressOccurred( ) )
+    /* Update state machine for every queued encoder button event, oldest first */
+    while( RotaryEncoder_GetButtonEvent( &buttonEvent ) )
     {
-        switch( RotaryEncoder_GetSwitchState( ) )
+        switch( buttonEvent.state )
         {
             case SWITCH_DOUBLE_CLICK:
                 if( PATTERN_MODE == app.state )
@@ -153,9 +162,65 @@ void APP_TASKS( void )
     return;
 }
 
+void APP_WaitForEvent( void )
+{
+    if( DISPLAY_TIME_MODE != app.state )
+    {
+        return;
+    }
+
+    /* With global interrupts off, an interrupt that fires before SLEEP still sets its flag, which
+     * makes SLEEP fall straight through. No event can be missed between the test and the SLEEP. */
+    bool hasIdled = false;
+    INTERRUPT_GlobalInterruptDisable( );
+    if( 0u == appPendingEvents )
+    {
+        CPUDOZEbits.IDLEN = 1; // IDLE, not SLEEP: TMR5 runs synchronized to the system clock
+        SLEEP( );
+        NOP( );
+        hasIdled = true;
+    }
+    INTERRUPT_GlobalInterruptEnable( ); // The waking interrupt is serviced here
+
+    INTERRUPT_GlobalInterruptDisable( );
+    uint8_t events = appPendingEvents;
+    appPendingEvents = 0u;
+    INTERRUPT_GlobalInterruptEnable( );
+
+    /* Events consumed without an IDLE woke nothing */
+    if( !hasIdled )
+    {
+        return;
+    }
+
+    uint8_t i;
+    for( i = 0; i < APP_NUM_WAKE_REASONS; i++ )
+    {
+        if( events & ( 1u << i ) )
+        {
+            app.wakeReasonCounts[i]++;
+        }
+    }
+    return;
+}
+
+/* Tick and encoder handlers, registered with their modules. Interrupt context. */
+static void App_PostTimeTickEvent( void )
+{
+    APP_POST_EVENT( APP_WAKE_TIME_TICK );
+    return;
+}
+
+static void App_PostEncoderEvent( void )
+{
+    APP_POST_EVENT( APP_WAKE_ENCODER );
+    return;
+}
+
 /*  Timer 1 interrupt handler. Toggle LED  */
 static void Timer1Interrupt( void )
 {
     FAULT_OUT_Toggle( );
+    APP_POST_EVENT( APP_WAKE_FAULT_TIMER );
     return;
 }
\ No newline at end of file
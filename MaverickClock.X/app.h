@@ -53,13 +53,25 @@ typedef struct // TODO
     bool isLEDWriteValid; // Error flag for LED writes. Determines out of bounds writes.
 } ApplicationStatus;
 
+/* Interrupt sources that wake the main loop. Each one posts its own pending event bit from the
+ * handler app.c registers with its module. */
+typedef enum
+{
+    APP_WAKE_TIME_TICK, // TMR5, once per second
+    APP_WAKE_ENCODER, // IOC, shaft or button edge
+    APP_WAKE_FAULT_TIMER, // TMR1, fault out LED toggle
+    APP_NUM_WAKE_REASONS
+} APP_WAKE_REASON;
+
 typedef struct
 {
     APP_STATE state;
     nvmColorSettings colors;
     ApplicationStatus status;
+    uint16_t wakeReasonCounts[APP_NUM_WAKE_REASONS]; // IDLE wakeups with each source's event pending. Wraps.
 } APP;
 
+
 /* Function:
  *      APP_Initialize
  *
@@ -79,6 +91,19 @@ void APP_Initialize(void);
 void APP_TASKS(void);
 
 
+/* Function:
+ *      APP_WaitForEvent
+ *
+ * Description:
+ *      In display time mode, puts the core in IDLE until an interrupt posts an event. Peripherals,
+ *      including every timer and IOC, keep running on the system clock. Returns immediately if an
+ *      event is already pending or in any other mode, since those modes animate or block on their
+ *      own. Consumes the pending events. After an IDLE, counts each source found pending in
+ *      app.wakeReasonCounts, so a source that only ever posts while the core is busy never counts.
+ */
+void APP_WaitForEvent(void);
+
+
 
 
 
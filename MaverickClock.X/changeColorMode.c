@@ -11,6 +11,8 @@
  * Mode requirements:
  *      Rotary encoder changes RGB value of "color segment".
  *      Color segments all start at white,
+ *      After the colors, the rotary encoder sets the timebase trim, shown in tens of ppm. Green
+ *      digits speed the clock up, red digits slow it down.
  *
  *
  */
@@ -19,6 +21,7 @@
 #include "changeColorMode.h"
 #include "rotaryEncoder.h"
 #include <string.h>
+#include <stdlib.h>
 #include "clockLEDs.h"
 #include "ws2812b.h"
 #include "CRC16bit.h"
@@ -35,6 +38,13 @@
 #define _XTAL_FREQ 32000000u
 #endif
 
+#define TRIM_PPM_PER_COUNT 10 // One detent, about 0.86 seconds per day
+#define TRIM_MAX_PPM 32760 // Largest multiple of TRIM_PPM_PER_COUNT an int16_t holds
+
+/*********************** Function Prototype(s) ***************************/
+static bool STATE_AdjustTimeTrim( void );
+static void STATE_RenderTrim( const int32_t trimPpm );
+
 
 /*********************** Local Variables (s) ****************************/
 /* Create local arrays stack allocated for color choices. */
@@ -72,7 +82,7 @@ bool STATE_ChangeColorMode( void )
     Clock_PrerenderPixelAndBackgroundValues( );
     Clock_ForceRender( &dColorTime );
 
-    RotaryEncoder_HasButtonPressOccurred( ); // Clear a possible button pressed flag
+    RotaryEncoder_FlushButtonEvents( ); // Clear any queued button presses
 
     int32_t rotCounts;
     int8_t arrayRowIdx = 0; // TODO should this be size_t?.
@@ -89,7 +99,6 @@ bool STATE_ChangeColorMode( void )
             Clock_SetDigitRGBArray( colorRGBArrays[arrayRowIdx][0],
                                     colorRGBArrays[arrayRowIdx][1],
                                     colorRGBArrays[arrayRowIdx][2] );
-            Clock_PrerenderPixelAndBackgroundValues( );
             Clock_ForceRender( &dColorTime );
         }
     }
@@ -103,7 +112,7 @@ bool STATE_ChangeColorMode( void )
         colorRGBArrays[arrayRowIdx][2]
     };
 
-    RotaryEncoder_HasButtonPressOccurred( ); // Clear a possible button pressed flag initially.
+    RotaryEncoder_FlushButtonEvents( ); // Clear any queued button presses initially.
     /* Background selection */
     do
     {
@@ -116,7 +125,6 @@ bool STATE_ChangeColorMode( void )
             Clock_SetBackgroundRGBArray( colorRGBArrays[arrayRowIdx][0],
                                          colorRGBArrays[arrayRowIdx][1],
                                          colorRGBArrays[arrayRowIdx][2] );
-            Clock_PrerenderPixelAndBackgroundValues( );
             Clock_ForceRender( &dColorTime );
         }
     }
@@ -176,8 +184,95 @@ bool STATE_ChangeColorMode( void )
         /* TODO flash screen red. return false; */
     }
 
+    /* Trim selection. Shown in its own colors, so the selections are restored after. */
+    if( !STATE_AdjustTimeTrim( ) )
+    {
+        wasReadbackValid = false;
+    }
+    Clock_SetDigitRGBArray( digitSelection[0], digitSelection[1], digitSelection[2] );
+    Clock_SetBackgroundRGBArray( backgroundSelection[0], backgroundSelection[1], backgroundSelection[2] );
+    Clock_PrerenderPixelAndBackgroundValues( );
+
     /* Rewrite time with previous valid time */
     uint32_t currentTime = Time_GetCurrentTimeInSeconds( );
     Time_RenderInputTime( currentTime, false );
     return wasReadbackValid;
 }
+
+/* Function:
+ *      STATE_AdjustTimeTrim
+ *
+ * Description:
+ *      Steps the timebase trim by TRIM_PPM_PER_COUNT per encoder count until the button is pressed,
+ *      then saves it if it changed.
+ *
+ * Return:
+ *      False if the trim changed and its EEPROM readback failed.
+ */
+static bool STATE_AdjustTimeTrim( void )
+{
+    int16_t savedTrimPpm = Time_GetTrimPpm( );
+    int32_t trimPpm = savedTrimPpm;
+    int32_t rotCounts;
+
+    RotaryEncoder_FlushButtonEvents( );
+    Clock_SetBackgroundRGBArray( 0u, 0u, 0u );
+    STATE_RenderTrim( trimPpm );
+    do
+    {
+        rotCounts = RotaryEncoder_GetShaftCounts( );
+        if( 0 != rotCounts )
+        {
+            trimPpm += rotCounts * TRIM_PPM_PER_COUNT;
+            if( trimPpm > TRIM_MAX_PPM )
+            {
+                trimPpm = TRIM_MAX_PPM;
+            }
+            else if( trimPpm < -TRIM_MAX_PPM )
+            {
+                trimPpm = -TRIM_MAX_PPM;
+            }
+            STATE_RenderTrim( trimPpm );
+        }
+    }
+    while( false == RotaryEncoder_HasButtonPressOccurred( ) );
+
+    if( trimPpm == savedTrimPpm )
+    {
+        return true;
+    }
+    return Time_SetTrimPpm( (int16_t) trimPpm );
+}
+
+/* Function:
+ *      STATE_RenderTrim
+ *
+ * Description:
+ *      Shows the trim magnitude in tens of ppm on the four digits. Green for a positive trim, red
+ *      for a negative one, white for none.
+ */
+static void STATE_RenderTrim( const int32_t trimPpm )
+{
+    uint16_t magnitude = (uint16_t) ( labs( trimPpm ) / TRIM_PPM_PER_COUNT );
+    const TimeInDigits trimDigits = {
+        .digit1 = (uint8_t) ( magnitude / 1000u ),
+        .digit2 = (uint8_t) ( ( magnitude / 100u ) % 10u ),
+        .digit3 = (uint8_t) ( ( magnitude / 10u ) % 10u ),
+        .digit4 = (uint8_t) ( magnitude % 10u )
+    };
+
+    if( trimPpm > 0 )
+    {
+        Clock_SetDigitRGBArray( 0u, 255u, 0u );
+    }
+    else if( trimPpm < 0 )
+    {
+        Clock_SetDigitRGBArray( 255u, 0u, 0u );
+    }
+    else
+    {
+        Clock_SetDigitRGBArray( 255u, 255u, 255u );
+    }
+    Clock_ForceRender( &trimDigits );
+    return;
+}
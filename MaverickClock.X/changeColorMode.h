@@ -35,7 +35,8 @@
  * Description:
  *      Iterates through the colors and allows the user to cycle through the available
  *      colors. Pushing the rotary encoder button allows the user to save the current
- *      color to the current option (background or digit).
+ *      color to the current option (background or digit). A last press saves the timebase
+ *      trim, see Time_SetTrimPpm.
  */
 bool STATE_ChangeColorMode(void);
 
@@ -12,22 +12,29 @@
  *      LED array instance used by the clock.
  *
  *      Display time mode: Contains the static render buffer as well as the ledArray
- *      structure. Uses prerending of designated digits and backgrounds to save clock cycles at runtime.
- *      At runtime, the corresponding time struct populates the render buffer. Only digits that have
- *      changed from the previous render are written to the render buffer. A "lookup table" is used
- *      from the prerendered values to save cycles. This way, at runtime, the corresponding pixels
- *      are simply copied from the prerendered lookup table. If the user changes the color configuration,
- *      the prerender function must be called again.
+ *      structure. At runtime, the corresponding time struct populates the render buffer. Only digits that have
+ *      changed from the previous render are written to the render buffer, and only the pixels up to the
+ *      last changed digit are sent to the strip. On this face that saves nothing on a minute change:
+ *      digit 4 is last in the chain (pixels 51-63) and changes every minute, so every minute still
+ *      sends all 64 pixels. Only a render with nothing changed is skipped outright. Each changed
+ *      digit's 16 bit encoding is expanded straight into the render buffer, so no prerendered copies
+ *      of the digits are kept in RAM.
+ *
+ *      Palette: the strip uses the driver's palette storage, a 4 bit index per pixel. Digits point
+ *      at PALETTE_DIGIT and everything else at PALETTE_BACKGROUND, so changing either color is a
+ *      single palette write and no pixel is rewritten. Both render buffers together take 64 bytes
+ *      plus the 48 byte palette, against the 192 bytes of a single RGB buffer. The prerender
+ *      function only points the whole face back at the background, after a pattern.
  *
  *      Digit 4 explanation: Digit 4 is annoying since it has 1 less pixel than every other digit, and
- *      must be treated differently. Because of this, the up encoded pixel buffer must have 1 more value
- *      than required. After it is prerendered, it requires a modification to the written pixel buffer
- *      in order to display the correct digit.
+ *      its last column is wired differently. It has its own 13 pixel encodings, digit4Encodings, whose
+ *      first 10 bits match the up encodings, and is expanded in one pass like every other digit.
  *
  *      Color change mode: Features a force render function. Color change mode has authority to rewrite the
  *      background colors and pixel buffers.
  *
- *      Pattern mode: Manually manipulates the screen buffer.
+ *      Pattern mode: Manually manipulates the screen buffer. Patterns draw from their own palette
+ *      entries, loaded with the pattern's colors, so the time colors survive a visit to pattern mode.
  *
  *
  */
@@ -35,6 +42,7 @@
 /*********************** Included File(s) ********************************/
 #include "clockLEDs.h"
 #include "ws2812b.h"
+#include "prng.h"
 #include <string.h>
 #include <xc.h>
 #include <stdlib.h>
@@ -46,19 +54,73 @@
 #endif
 
 #define TOTAL_NUM_DIGITS 10u
-#define NUM_PIXELS_PER_DIGIT 14u // Note: digit 4 only has 13 pixels.
-#define NUM_PIXELS_DIGIT_4_OFFSET 3u
+#define NUM_PIXELS_PER_DIGIT 14u
+#define NUM_PIXELS_DIGIT_4 13u // Digit 4 has 1 less pixel than the others, and its own encodings
 
-#define DIGIT4_START_FIX_ADDRESS 61u
-#define NUM_PIXELS_TO_FIX_DIGIT4 3u
+#define NUM_POPCORN_PIXELS 8u
+#define POPCORN_PIXEL_MASK ( NUM_CLOCK_PIXELS - 1u )
+#if ( NUM_CLOCK_PIXELS & ( NUM_CLOCK_PIXELS - 1 ) ) != 0
+#error "Popcorn location mask requires NUM_CLOCK_PIXELS to be a power of two"
+#endif
 
-/*********************** Local Variable(s) *******************************/
-static __pack ws2812bPixel renderBuffer [NUM_CLOCK_PIXELS]; // actual render buffer
-static ws2812bArray ledArray; // Local instance of led strip/array. Linked to renderBuffer
+#if ( WS2812B_STORAGE != WS2812B_STORAGE_PALETTE )
+#error "The clock draws every color from a palette, build ws2812b.c with WS2812B_STORAGE_PALETTE"
+#endif
+
+/* Palette entries. Time mode only uses the first two. */
+#define PALETTE_BACKGROUND 0u
+#define PALETTE_DIGIT 1u
+#define PALETTE_OFF 2u // Black, the patterns clear the face to it
+#define PALETTE_WHITE 3u // Single pixel pattern
+#define PALETTE_FIRST_SWEEP_COLOR 4u // CLOCK_MAX_SWEEP_COLORS entries, the active sweep's colors
+#define PALETTE_FIRST_POPCORN_COLOR ( PALETTE_FIRST_SWEEP_COLOR + CLOCK_MAX_SWEEP_COLORS ) // Random colors to the end
+#define NUM_POPCORN_COLORS ( WS2812B_PALETTE_SIZE - PALETTE_FIRST_POPCORN_COLOR )
+#if ( NUM_POPCORN_COLORS < 1 )
+#error "No palette entries left for the popcorn colors"
+#endif
 
+/*********************** Local Variable(s) *******************************/
+static __pack ws2812bStorage renderBuffer [WS2812B_STORAGE_SIZE( NUM_CLOCK_PIXELS )]; // back buffer, every write is composed here
+static __pack ws2812bStorage displayBuffer [WS2812B_STORAGE_SIZE( NUM_CLOCK_PIXELS )]; // front buffer, only ever transmitted
+static ws2812bArray ledArray; // Local instance of led strip/array. Linked to renderBuffer and displayBuffer
+
+
+
+/* Face geometry. The single description of the wiring, one column per line, top to bottom. PIXEL( pixel, x, y )
+ * is a wired cell, EMPTY( x, y ) is a cell with no pixel. y is the row, 0 at the top. x is the column, 0 at
+ * the left. Rows are staggered, so the outer rows start one and two columns in from the middle row. */
+#define CLOCK_FACE_GRID(PIXEL, EMPTY) \
+    EMPTY(  0u, 0u ) EMPTY(  0u, 1u ) PIXEL(  0u,  0u, 2u ) EMPTY(  0u, 3u ) EMPTY(  0u, 4u ) \
+    EMPTY(  1u, 0u ) PIXEL(  4u,  1u, 1u ) PIXEL(  3u,  1u, 2u ) PIXEL(  2u,  1u, 3u ) EMPTY(  1u, 4u ) \
+    PIXEL(  5u,  2u, 0u ) PIXEL(  7u,  2u, 1u ) PIXEL(  8u,  2u, 2u ) PIXEL(  9u,  2u, 3u ) PIXEL(  1u,  2u, 4u ) \
+    PIXEL(  6u,  3u, 0u ) PIXEL( 14u,  3u, 1u ) PIXEL( 13u,  3u, 2u ) PIXEL( 12u,  3u, 3u ) PIXEL( 10u,  3u, 4u ) \
+    PIXEL( 15u,  4u, 0u ) PIXEL( 17u,  4u, 1u ) PIXEL( 18u,  4u, 2u ) PIXEL( 19u,  4u, 3u ) PIXEL( 11u,  4u, 4u ) \
+    PIXEL( 16u,  5u, 0u ) PIXEL( 24u,  5u, 1u ) PIXEL( 23u,  5u, 2u ) PIXEL( 22u,  5u, 3u ) PIXEL( 20u,  5u, 4u ) \
+    PIXEL( 25u,  6u, 0u ) PIXEL( 27u,  6u, 1u ) PIXEL( 28u,  6u, 2u ) PIXEL( 29u,  6u, 3u ) PIXEL( 21u,  6u, 4u ) \
+    PIXEL( 26u,  7u, 0u ) PIXEL( 34u,  7u, 1u ) PIXEL( 33u,  7u, 2u ) PIXEL( 32u,  7u, 3u ) PIXEL( 30u,  7u, 4u ) \
+    PIXEL( 35u,  8u, 0u ) PIXEL( 37u,  8u, 1u ) PIXEL( 38u,  8u, 2u ) PIXEL( 39u,  8u, 3u ) PIXEL( 31u,  8u, 4u ) \
+    PIXEL( 36u,  9u, 0u ) PIXEL( 44u,  9u, 1u ) PIXEL( 43u,  9u, 2u ) PIXEL( 42u,  9u, 3u ) PIXEL( 40u,  9u, 4u ) \
+    PIXEL( 45u, 10u, 0u ) PIXEL( 47u, 10u, 1u ) PIXEL( 48u, 10u, 2u ) PIXEL( 49u, 10u, 3u ) PIXEL( 41u, 10u, 4u ) \
+    PIXEL( 46u, 11u, 0u ) PIXEL( 54u, 11u, 1u ) PIXEL( 53u, 11u, 2u ) PIXEL( 52u, 11u, 3u ) PIXEL( 50u, 11u, 4u ) \
+    PIXEL( 55u, 12u, 0u ) PIXEL( 57u, 12u, 1u ) PIXEL( 58u, 12u, 2u ) PIXEL( 59u, 12u, 3u ) PIXEL( 51u, 12u, 4u ) \
+    PIXEL( 56u, 13u, 0u ) PIXEL( 63u, 13u, 1u ) PIXEL( 62u, 13u, 2u ) PIXEL( 61u, 13u, 3u ) PIXEL( 60u, 13u, 4u )
+
+/* Pixel to (x, y), packed as y in the high nibble and x in the low nibble */
+#define GEOMETRY_PACK_XY(x, y) ( (uint8_t) ( ( (y) << 4u ) | (x) ) )
+#define GEOMETRY_FORWARD_PIXEL(pixel, x, y) [pixel] = GEOMETRY_PACK_XY( x, y ),
+#define GEOMETRY_FORWARD_EMPTY(x, y)
+static const uint8_t pixelPositions[NUM_CLOCK_PIXELS] = {
+    CLOCK_FACE_GRID( GEOMETRY_FORWARD_PIXEL, GEOMETRY_FORWARD_EMPTY )
+};
 
+/* (x, y) to pixel, one column of CLOCK_FACE_HEIGHT pixels per x */
+#define GEOMETRY_INVERSE_PIXEL(pixel, x, y) [x][y] = pixel,
+#define GEOMETRY_INVERSE_EMPTY(x, y) [x][y] = CLOCK_NO_PIXEL,
+static const uint8_t faceColumns[CLOCK_FACE_WIDTH][CLOCK_FACE_HEIGHT] = {
+    CLOCK_FACE_GRID( GEOMETRY_INVERSE_PIXEL, GEOMETRY_INVERSE_EMPTY )
+};
 
-/* Start indices of each respective digit */
+/* Start indices of each respective digit along the chain. Glyph encodings are in chain order. */
 static const size_t digit1StartPixel = 1;
 static const size_t digit2StartPixel = 16;
 static const size_t digit3StartPixel = 36;
@@ -66,29 +128,16 @@ static const size_t digit4StartPixel = 51;
 
 
 
-/* These local arrays allow the user to change RGB values of digits and background at runtime*/
-static uint8_t currentDIGITrgbArray[NUM_BYTES_IN_PIXEL]; // Populated at startup
-static uint8_t currentBACKGROUNDrgbArray[NUM_BYTES_IN_PIXEL]; // Populated at startup
-
-
-
-/* Statically allocated prerendered digit buffers. This allows simply copying the desired
- * values over to the render buffer at runtime instead of calculating each RGB pixel value. If the
- * background color or digit color ever changes, these must be recalculated before time display mode starts.
- * Up encoded digits (1 and 4) are the same, as are the down encoded digits (2 and 3). Digit 4 requires
- * special modification after copying the indexed pixel buffer from the upEncodeDigitsPixelValues buffer.
- *
- * At runtime, to write to the render buffer, simply use the prerendered array as a source and enter the starting digit into the
- * function WS2812b_CopyPixelBufferArrayFromSource.
- */
-static __pack ws2812bPixel upEncodedDigitsPixelValues[TOTAL_NUM_DIGITS][NUM_PIXELS_PER_DIGIT]; // Digits 1 and 4
-static __pack ws2812bPixel downEncodedDigitsPixelValues[TOTAL_NUM_DIGITS][NUM_PIXELS_PER_DIGIT]; // Digits 2 and 3
+static const ColumnSweepDescriptor * activeSweep = NULL; // Sweep the column and color indices below belong to
+static uint8_t sweepColumnIdx = 0u;
+static uint8_t sweepColorIdx = 0u;
+static uint8_t numSweepColors = 0u; // Colors of the active sweep loaded into the palette
 
 
 
 /* Digit encodings:
- * Digits are encoded based on the starting pixel. Digits 1 and 4 have equal encodings, with
- * digit 4's last bit being zero. All digits are encoded MSB first.
+ * Digits are encoded based on the starting pixel. Every digit is written in a single pass from
+ * its encoding. All digits are encoded MSB first.
  *
  * Digits 1 and 4 are "up". Digits 2 and 3 are "down". Last two bits are ALWAYS zero.
  */
@@ -106,6 +155,21 @@ static const uint16_t upDigitEncodings[TOTAL_NUM_DIGITS] = {
     0b1011110110000100 // nine
 };
 
+/* Digit 4 shares the first 10 pixels with the up digits. Its last three pixels (61-63) follow a
+ * different layout, so it has its own 13 bit encodings. Last three bits are ALWAYS zero. */
+static const uint16_t digit4Encodings[TOTAL_NUM_DIGITS] = {
+    0b1101110001101000, // zero
+    0b0000010101101000, // one
+    0b1110110101001000, // two
+    0b1010110101101000, // three
+    0b1011100110001000, // four
+    0b1011110101100000, // five
+    0b1110011101100000, // six
+    0b1000110110001000, // seven
+    0b1111110101101000, // eight
+    0b1011110110001000 // nine
+};
+
 static const uint16_t downDigitEncodings[TOTAL_NUM_DIGITS] = {
     0b1101110001010100, // zero
     0b0000010101010100, // one
@@ -121,10 +185,11 @@ static const uint16_t downDigitEncodings[TOTAL_NUM_DIGITS] = {
 
 
 /*********************** Function Prototype(s) ***************************/
-static void Clock_WriteDigitPixelValuesToLocalPxlBuffers( ws2812bPixel * const pixelBuffer,
-                                                          const uint16_t * encodingSource );
-
-static void Clock_FixDigit4LastThreePixels( const uint8_t digit4Value );
+static void Clock_WriteDigitGlyph( const size_t startPixel,
+                                   const size_t numPixels,
+                                   const uint16_t encoding );
+static void Clock_ScatterPopcornPixels( void );
+static void Clock_PickPopcornColors( void );
 
 /************************** Functions ************************************/
 
@@ -136,6 +201,14 @@ bool Clock_InitializeClockLEDs( const size_t numElements,
                                 const uint8_t backgroundGreen,
                                 const uint8_t backgroundBlue )
 {
+    bool returnVal;
+    ledArray = WS2812b_InitializeDoubleBuffered( renderBuffer,
+                                                 displayBuffer,
+                                                 numElements,
+                                                 WS2812B_FLIP_COPY_DIRTY,
+                                                 &returnVal );
+
+    /* The palette lives in ledArray, so it can only be filled once the strip exists */
     Clock_SetDigitRGBArray( digitRed,
                             digitGreen,
                             digitBlue );
@@ -143,8 +216,8 @@ bool Clock_InitializeClockLEDs( const size_t numElements,
     Clock_SetBackgroundRGBArray( backgroundRed,
                                  backgroundGreen,
                                  backgroundBlue );
-    bool returnVal;
-    ledArray = WS2812b_Initialize( renderBuffer, numElements, &returnVal );
+    WS2812b_SetPaletteColor( &ledArray, PALETTE_OFF, 0u, 0u, 0u );
+    WS2812b_SetPaletteColor( &ledArray, PALETTE_WHITE, 0xFFu, 0xFFu, 0xFFu );
     return returnVal;
 }
 
@@ -152,18 +225,14 @@ void Clock_SetBackgroundRGBArray( const uint8_t red,
                                   const uint8_t green,
                                   const uint8_t blue )
 {
-    currentBACKGROUNDrgbArray[0] = red;
-    currentBACKGROUNDrgbArray[1] = green;
-    currentBACKGROUNDrgbArray[2] = blue;
+    WS2812b_SetPaletteColor( &ledArray, PALETTE_BACKGROUND, red, green, blue );
 }
 
 void Clock_SetDigitRGBArray( const uint8_t red,
                              const uint8_t green,
                              const uint8_t blue )
 {
-    currentDIGITrgbArray[0] = red;
-    currentDIGITrgbArray[1] = green;
-    currentDIGITrgbArray[2] = blue;
+    WS2812b_SetPaletteColor( &ledArray, PALETTE_DIGIT, red, green, blue );
 }
 
 void Clock_WriteTimeDigitValuesAndRenderScreen( const TimeInDigits * const digits )
@@ -177,193 +246,125 @@ void Clock_WriteTimeDigitValuesAndRenderScreen( const TimeInDigits * const digit
     if( digits->digit1 != lastDigit1 )
     {
         lastDigit1 = digits->digit1;
-        WS2812b_CopyPixelBufferArrayFromSource( &ledArray,
-                                                upEncodedDigitsPixelValues[digits->digit1],
-                                                digit1StartPixel,
-                                                NUM_PIXELS_PER_DIGIT );
+        Clock_WriteDigitGlyph( digit1StartPixel,
+                               NUM_PIXELS_PER_DIGIT,
+                               upDigitEncodings[digits->digit1] );
     }
     if( digits->digit2 != lastDigit2 )
     {
         lastDigit2 = digits->digit2;
-        WS2812b_CopyPixelBufferArrayFromSource( &ledArray,
-                                                downEncodedDigitsPixelValues[digits->digit2],
-                                                digit2StartPixel,
-                                                NUM_PIXELS_PER_DIGIT );
+        Clock_WriteDigitGlyph( digit2StartPixel,
+                               NUM_PIXELS_PER_DIGIT,
+                               downDigitEncodings[digits->digit2] );
     }
     if( digits->digit3 != lastDigit3 )
     {
         lastDigit3 = digits->digit3;
-        WS2812b_CopyPixelBufferArrayFromSource( &ledArray,
-                                                downEncodedDigitsPixelValues[digits->digit3],
-                                                digit3StartPixel,
-                                                NUM_PIXELS_PER_DIGIT );
+        Clock_WriteDigitGlyph( digit3StartPixel,
+                               NUM_PIXELS_PER_DIGIT,
+                               downDigitEncodings[digits->digit3] );
     }
     if( digits->digit4 != lastDigit4 )
     {
         lastDigit4 = digits->digit4;
-        /* Digit 4 has 1 less pixel than every other digit, along with a special encoding, so a
-         * helper function to modify the render buffer back to normal must be called.
-         *  */
-        WS2812b_CopyPixelBufferArrayFromSource( &ledArray,
-                                                upEncodedDigitsPixelValues[digits->digit4],
-                                                digit4StartPixel,
-                                                NUM_PIXELS_PER_DIGIT - 4 ); // The last 4 pixels are written separately
-
-        // Fix digit 4's final three pixels.
-        Clock_FixDigit4LastThreePixels( digits->digit4 );
+        Clock_WriteDigitGlyph( digit4StartPixel,
+                               NUM_PIXELS_DIGIT_4,
+                               digit4Encodings[digits->digit4] );
     }
-    WS2812B_Render( &ledArray );
+
+    /* Pixels past the last changed digit already show the right colors. Digit 4 ends the chain and
+     * changes every minute, so in practice the prefix is the whole strip. */
+    WS2812B_FlipBuffers( &ledArray );
+    WS2812B_RenderDirtyPrefix( &ledArray );
     return;
 }
 
 void Clock_PrerenderPixelAndBackgroundValues( void )
 {
-    /* Write the entirety of the background colors to the render buffer */
-    WS2812b_SetStripConstantColor( &ledArray,
-                                   currentBACKGROUNDrgbArray[WS2812B_RED_INDEX],
-                                   currentBACKGROUNDrgbArray[WS2812B_GREEN_INDEX],
-                                   currentBACKGROUNDrgbArray[WS2812B_BLUE_INDEX] );
-
-    /* Prerender up encoded digits to the local pixel buffers */
-    Clock_WriteDigitPixelValuesToLocalPxlBuffers( upEncodedDigitsPixelValues[0],
-                                                  upDigitEncodings );
-
-    /* Prerender down encoded digits to the local pixel buffers */
-    Clock_WriteDigitPixelValuesToLocalPxlBuffers( downEncodedDigitsPixelValues[0],
-                                                  downDigitEncodings );
-
+    /* Point every pixel at the background entry. Digits point at the digit entry whenever they
+     * are written, and the colors themselves only live in the palette. */
+    WS2812b_SetStripPaletteIndex( &ledArray, PALETTE_BACKGROUND );
     return;
 }
 
 /* Function:
- *      Clock_WriteDigitPixelValuesToLocalPxlBuffers
+ *      Clock_WriteDigitGlyph
  *
  * Description:
- *      Function called by prerenderer to populate the local pixel buffers with the
- *      correct colors based on the digit encodings. Uses the pixelBuffer input pointer
- *      as the destination of writing, and the encodingSource pointer as a source for
- *      logical writes.
- *
- *      Write logic:
- *      FOR every digit:
- *          FOR all bits of encoding:
- *              IF the encoding source MSB is 1
- *                  Copy the rgb array into the pixel buffer
- *              Increment pixel buffer destination ptr by 3 bytes
- *          Increment encoding source pointer by 1 value (2 bytes).
- *
- * Precondition: currentDIGITrgbArray and currentBACKGROUNDrgbArray must have been populated.
+ *      Expands a digit encoding straight into the render buffer. Encoding bits are read MSB first,
+ *      a 1 points the pixel at the digit entry and a 0 at the background entry.
  *
  */
-static void Clock_WriteDigitPixelValuesToLocalPxlBuffers( ws2812bPixel * const pixelBuffer,
-                                                          const uint16_t * encodingSource )
+static void Clock_WriteDigitGlyph( const size_t startPixel,
+                                   const size_t numPixels,
+                                   const uint16_t encoding )
 {
-    size_t digitCounter;
-    size_t encodingCounter;
-    uint8_t * thisDigitStartAddress = &( pixelBuffer->red );
-    for( digitCounter = 0; digitCounter < TOTAL_NUM_DIGITS; digitCounter++ )
-    {
-        for( encodingCounter = 0; encodingCounter < NUM_PIXELS_PER_DIGIT; encodingCounter++ )
-        {
-            // if the encoding has a 1 value, write the RGB values to the pixel buffer.
-            if( ( *encodingSource << encodingCounter ) & 0x8000u )
-            {
-                memcpy( thisDigitStartAddress, currentDIGITrgbArray, NUM_BYTES_IN_PIXEL );
-            }
-            else // Write background color
-            {
-                memcpy( thisDigitStartAddress, currentBACKGROUNDrgbArray, NUM_BYTES_IN_PIXEL );
-            }
-            thisDigitStartAddress += NUM_BYTES_IN_PIXEL;
-        }
-        encodingSource++;
-    }
+    WS2812b_SetPixelBlockFromBitmaskPaletteIndex( &ledArray,
+                                                  startPixel,
+                                                  numPixels,
+                                                  encoding,
+                                                  PALETTE_DIGIT,
+                                                  PALETTE_BACKGROUND );
+    return;
 }
 
-/* Function:
- *      Clock_FixDigit4LastThreePixels
- *
- * Description: Annoying fix for digit 4. Not the most elegant solution, but it's the
- *      only real work around based on memory constraints. Can't have an entire pixel buffer
- *      for every digit for3 pixels that can just be hard coded like so.
- */
-static void Clock_FixDigit4LastThreePixels( const uint8_t digit4Value )
+/****************************************** Geometry Functions ************************************/
+
+uint8_t Clock_GetPixelX( const uint8_t pixel )
 {
-    /* Write the block of pixels from 61-63 the background color*/
-    WS2812b_SetPixelBlockConstantColor( &ledArray,
-                                        DIGIT4_START_FIX_ADDRESS,
-                                        NUM_PIXELS_TO_FIX_DIGIT4,
-                                        currentBACKGROUNDrgbArray[0],
-                                        currentBACKGROUNDrgbArray[1],
-                                        currentBACKGROUNDrgbArray[2] );
-
-    /* 11 */
-    if( ( 0u == digit4Value ) ||
-        ( 1u == digit4Value ) ||
-        ( 3u == digit4Value ) ||
-        ( 8u == digit4Value ) )
+    if( pixel >= NUM_CLOCK_PIXELS )
     {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     61,
-                                     currentDIGITrgbArray[0],
-                                     currentDIGITrgbArray[1],
-                                     currentDIGITrgbArray[2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     63,
-                                     currentDIGITrgbArray[0],
-                                     currentDIGITrgbArray[1],
-                                     currentDIGITrgbArray[2] );
+        return CLOCK_NO_PIXEL;
     }
-        /* 10*/
-    else if( ( 2u == digit4Value ) ||
-             ( 7u == digit4Value ) ||
-             ( 9u == digit4Value ) ||
-             ( 4u == digit4Value ) )
+    return pixelPositions[pixel] & 0x0Fu;
+}
+
+uint8_t Clock_GetPixelY( const uint8_t pixel )
+{
+    if( pixel >= NUM_CLOCK_PIXELS )
     {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     63,
-                                     currentDIGITrgbArray[0],
-                                     currentDIGITrgbArray[1],
-                                     currentDIGITrgbArray[2] );
+        return CLOCK_NO_PIXEL;
     }
-        /* 01 */
-    else if( ( 5u == digit4Value ) ||
-             ( 6u == digit4Value ) )
+    return pixelPositions[pixel] >> 4u;
+}
+
+uint8_t Clock_GetPixelAt( const uint8_t x,
+                          const uint8_t y )
+{
+    if( ( x >= CLOCK_FACE_WIDTH ) || ( y >= CLOCK_FACE_HEIGHT ) )
     {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     61,
-                                     currentDIGITrgbArray[0],
-                                     currentDIGITrgbArray[1],
-                                     currentDIGITrgbArray[2] );
+        return CLOCK_NO_PIXEL;
     }
-    else
+    return faceColumns[x][y];
+}
+
+const uint8_t * Clock_GetColumnPixels( const uint8_t x )
+{
+    if( x >= CLOCK_FACE_WIDTH )
     {
+        return NULL;
     }
-    return;
+    return faceColumns[x];
 }
 
 /****************************************** Color Change Mode Functions ************************************/
 
 void Clock_ForceRender( const TimeInDigits * const t )
 {
-    WS2812b_CopyPixelBufferArrayFromSource( &ledArray,
-                                            upEncodedDigitsPixelValues[t->digit1],
-                                            digit1StartPixel,
-                                            NUM_PIXELS_PER_DIGIT );
-    WS2812b_CopyPixelBufferArrayFromSource( &ledArray,
-                                            downEncodedDigitsPixelValues[t->digit2],
-                                            digit2StartPixel,
-                                            NUM_PIXELS_PER_DIGIT );
-    WS2812b_CopyPixelBufferArrayFromSource( &ledArray,
-                                            downEncodedDigitsPixelValues[t->digit3],
-                                            digit3StartPixel,
-                                            NUM_PIXELS_PER_DIGIT );
-    WS2812b_CopyPixelBufferArrayFromSource( &ledArray,
-                                            upEncodedDigitsPixelValues[t->digit4],
-                                            digit4StartPixel,
-                                            NUM_PIXELS_PER_DIGIT - 4 ); // The last 4 pixels are written separately
-    Clock_FixDigit4LastThreePixels( t->digit4 );
-    WS2812B_Render( &ledArray );
+    Clock_WriteDigitGlyph( digit1StartPixel,
+                           NUM_PIXELS_PER_DIGIT,
+                           upDigitEncodings[t->digit1] );
+    Clock_WriteDigitGlyph( digit2StartPixel,
+                           NUM_PIXELS_PER_DIGIT,
+                           downDigitEncodings[t->digit2] );
+    Clock_WriteDigitGlyph( digit3StartPixel,
+                           NUM_PIXELS_PER_DIGIT,
+                           downDigitEncodings[t->digit3] );
+    Clock_WriteDigitGlyph( digit4StartPixel,
+                           NUM_PIXELS_DIGIT_4,
+                           digit4Encodings[t->digit4] );
+    WS2812B_FlipBuffers( &ledArray );
+    WS2812B_Render( &ledArray, false );
     return;
 }
 
@@ -382,21 +383,16 @@ void Clock_IterateSinglePixelByIndex( void )
 #define MAX_IDX_VALUE 63
     static size_t idx = 0;
 
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 idx,
-                                 0xFF,
-                                 0xFF,
-                                 0xFF );
-    WS2812B_Render( &ledArray );
+    WS2812b_SetSinglePixelPaletteIndex( &ledArray,
+                                        idx,
+                                        PALETTE_WHITE );
+    WS2812B_FlipBuffers( &ledArray );
+    WS2812B_RenderDirtyPrefix( &ledArray );
 
-    __delay_ms( 50 );
     if( MAX_IDX_VALUE == idx )
     {
         idx = 0;
-        WS2812b_SetStripConstantColor( &ledArray,
-                                       0u,
-                                       0u,
-                                       0u );
+        WS2812b_SetStripPaletteIndex( &ledArray, PALETTE_OFF );
     }
     else
     {
@@ -407,12 +403,6 @@ void Clock_IterateSinglePixelByIndex( void )
 
 
 /******************************** LED Profile ******************************/
-static const uint8_t row1[12] = {5, 6, 15, 16, 25, 26, 35, 36, 45, 46, 55, 56};
-static const uint8_t row2[13] = {4, 7, 14, 17, 24, 27, 34, 37, 44, 47, 54, 57, 63};
-static const uint8_t row3[14] = {0, 3, 8, 13, 18, 23, 28, 33, 38, 43, 48, 53, 58, 62};
-static const uint8_t row4[13] = {2, 9, 12, 19, 22, 29, 32, 39, 42, 49, 52, 59, 61};
-static const uint8_t row5[12] = {1, 10, 11, 20, 21, 30, 31, 40, 41, 50, 51, 60};
-
 static const uint8_t rainbowRGBValues[6][3] = {
     {0xFFu, 0x00u, 0x00u}, // Red
     {255u, 69u, 0u}, // Orange
@@ -422,226 +412,124 @@ static const uint8_t rainbowRGBValues[6][3] = {
     {0xFFu, 0x00u, 0xFFu} // Magenta
 };
 
-void Clock_CrossingRainbowPattern( )
-{
-
-#define MAX_LED_INDEX_RAINBOW 13
-#define RAINBOW_INDEX_MAX 5
-    static size_t thisIndex = 0;
-    static size_t rainbowRowIdx = 0;
+const ColumnSweepDescriptor Clock_RainbowSweep = {
+    .columnMap = faceColumns,
+    .numColumns = CLOCK_FACE_WIDTH,
+    .colors = rainbowRGBValues,
+    .numColors = 6u,
+    .direction = SWEEP_LEFT_TO_RIGHT
+};
 
+void Clock_RestartColumnSweep( void )
+{
+    activeSweep = NULL;
+    return;
+}
 
-    /* thisIndex values of 0 only iterate middle row. */
-    if( 0 == thisIndex )
-    {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row3[thisIndex],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-    }
+void Clock_StepColumnSweep( const ColumnSweepDescriptor * const sweep )
+{
+    uint8_t i;
 
-        /* thisIndex values of 1 iterate middle three rows. */
-    else if( 1 == thisIndex )
+    /* Start a newly selected or restarted sweep from its first column and color, with its colors
+     * in the sweep's palette entries. Colors past CLOCK_MAX_SWEEP_COLORS are dropped. */
+    if( sweep != activeSweep )
     {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row2[thisIndex - 1],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row3[thisIndex],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row4[thisIndex - 1],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
+        activeSweep = sweep;
+        sweepColumnIdx = 0u;
+        sweepColorIdx = 0u;
+        numSweepColors = ( sweep->numColors > CLOCK_MAX_SWEEP_COLORS ) ? CLOCK_MAX_SWEEP_COLORS : sweep->numColors;
+        for( i = 0u; i < numSweepColors; i++ )
+        {
+            WS2812b_SetPaletteColor( &ledArray,
+                                     PALETTE_FIRST_SWEEP_COLOR + i,
+                                     sweep->colors[i][0],
+                                     sweep->colors[i][1],
+                                     sweep->colors[i][2] );
+        }
     }
 
-        /* thisIndex values of 2 and greater iterate all rows. */
-    else
+    uint8_t column = ( SWEEP_LEFT_TO_RIGHT == sweep->direction ) ? sweepColumnIdx : ( sweep->numColumns - 1u - sweepColumnIdx );
+    for( i = 0u; i < CLOCK_FACE_HEIGHT; i++ )
     {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row1[thisIndex - 2],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row2[thisIndex - 1],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row3[thisIndex],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row4[thisIndex - 1],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row5[thisIndex - 2],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
+        uint8_t pixel = sweep->columnMap[column][i];
+        if( CLOCK_NO_PIXEL != pixel )
+        {
+            WS2812b_SetSinglePixelPaletteIndex( &ledArray,
+                                                pixel,
+                                                PALETTE_FIRST_SWEEP_COLOR + sweepColorIdx );
+        }
     }
 
-    /* Limits thisIndex between 0-14. Every reset of thisIndex triggers a rainbowIdx increment. rainbowIdx
-     * is limited from 0-6.
-     */
-    if( MAX_LED_INDEX_RAINBOW == thisIndex )
-    {
-        thisIndex = 0;
-        rainbowRowIdx = ( RAINBOW_INDEX_MAX == rainbowRowIdx ) ? 0 : rainbowRowIdx + 1;
-    }
-    else
+    /* Every pass across the columns moves to the next color */
+    sweepColumnIdx++;
+    if( sweep->numColumns == sweepColumnIdx )
     {
-        thisIndex++;
+        sweepColumnIdx = 0u;
+        sweepColorIdx++;
+        if( numSweepColors <= sweepColorIdx )
+        {
+            sweepColorIdx = 0u;
+        }
     }
-    WS2812B_Render( &ledArray );
+    WS2812B_FlipBuffers( &ledArray );
+    WS2812B_Render( &ledArray, false );
     return;
-
 }
 
-void Clock_CrossingRainbowPatternwithDelays( )
+/* Function:
+ *      Clock_ScatterPopcornPixels
+ *
+ * Description:
+ *      Lights NUM_POPCORN_PIXELS random locations anywhere on the face, taking the popcorn palette
+ *      entries in turn. The pixel count is a power of two, so a mask picks the location without a
+ *      modulo.
+ */
+static void Clock_ScatterPopcornPixels( void )
 {
-
-#define MAX_LED_INDEX_RAINBOW 13
-#define RAINBOW_INDEX_MAX 5
-    static size_t thisIndex = 0;
-    static size_t rainbowRowIdx = 0;
-
-
-    /* thisIndex values of 0 only iterate middle row. */
-    if( 0 == thisIndex )
-    {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row3[thisIndex],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-    }
-
-        /* thisIndex values of 1 iterate middle three rows. */
-    else if( 1 == thisIndex )
-    {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row2[thisIndex - 1],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row3[thisIndex],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row4[thisIndex - 1],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-    }
-
-        /* thisIndex values of 2 and greater iterate all rows. */
-    else
+    uint8_t i;
+    uint8_t entry = PALETTE_FIRST_POPCORN_COLOR;
+    for( i = 0u; i < NUM_POPCORN_PIXELS; i++ )
     {
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row1[thisIndex - 2],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row2[thisIndex - 1],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row3[thisIndex],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row4[thisIndex - 1],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
-        WS2812b_SetSinglePixelColor( &ledArray,
-                                     row5[thisIndex - 2],
-                                     rainbowRGBValues[rainbowRowIdx][0],
-                                     rainbowRGBValues[rainbowRowIdx][1],
-                                     rainbowRGBValues[rainbowRowIdx][2] );
+        WS2812b_SetSinglePixelPaletteIndex( &ledArray,
+                                            ( PRNG_Next8( ) & POPCORN_PIXEL_MASK ),
+                                            entry );
+        entry++;
+        if( WS2812B_PALETTE_SIZE == entry )
+        {
+            entry = PALETTE_FIRST_POPCORN_COLOR;
+        }
     }
+    return;
+}
 
-    /* Limits thisIndex between 0-14. Every reset of thisIndex triggers a rainbowIdx increment. rainbowIdx
-     * is limited from 0-6.
-     */
-    if( MAX_LED_INDEX_RAINBOW == thisIndex )
-    {
-        thisIndex = 0;
-        rainbowRowIdx = ( RAINBOW_INDEX_MAX == rainbowRowIdx ) ? 0 : rainbowRowIdx + 1;
-    }
-    else
+/* Function:
+ *      Clock_PickPopcornColors
+ *
+ * Description:
+ *      Fills the popcorn palette entries with random colors. Every lit popcorn pixel takes the new
+ *      colors on the next render, so callers only pick them when the face has just been cleared.
+ */
+static void Clock_PickPopcornColors( void )
+{
+    uint8_t entry;
+    for( entry = PALETTE_FIRST_POPCORN_COLOR; entry < WS2812B_PALETTE_SIZE; entry++ )
     {
-        thisIndex++;
+        WS2812b_SetPaletteColor( &ledArray,
+                                 entry,
+                                 PRNG_Next8( ),
+                                 PRNG_Next8( ),
+                                 PRNG_Next8( ) );
     }
-    WS2812B_Render( &ledArray );
-    __delay_ms( 75 );
     return;
 }
 
 void Clock_Popcorn_Pattern( void )
 {
-    WS2812b_SetStripConstantColor( &ledArray,
-                                   0u,
-                                   0u,
-                                   0u );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812B_Render( &ledArray );
-    __delay_ms( 150 );
+    WS2812b_SetStripPaletteIndex( &ledArray, PALETTE_OFF );
+    Clock_PickPopcornColors( );
+    Clock_ScatterPopcornPixels( );
+    WS2812B_FlipBuffers( &ledArray );
+    WS2812B_Render( &ledArray, false );
 }
 
 void Clock_Popcorn_Pattern_Hold( void )
@@ -649,55 +537,18 @@ void Clock_Popcorn_Pattern_Hold( void )
 #define NUM_RENDERS_BEFORE_RESET 8
     static size_t numRenders = 0;
 
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812b_SetSinglePixelColor( &ledArray,
-                                 ( (uint8_t) rand( ) % TOTAL_NUM_DIGITS ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ),
-                                 ( rand( ) % 255 ) );
-    WS2812B_Render( &ledArray );
-    __delay_ms( 150 );
+    /* One set of colors per hold, so the pixels already lit keep theirs */
+    if( 0u == numRenders )
+    {
+        Clock_PickPopcornColors( );
+    }
+    Clock_ScatterPopcornPixels( );
+    WS2812B_FlipBuffers( &ledArray );
+    WS2812B_Render( &ledArray, false );
     numRenders++;
     if( NUM_RENDERS_BEFORE_RESET == numRenders )
     {
-        WS2812b_SetStripConstantColor( &ledArray,
-                                       0u,
-                                       0u,
-                                       0u );
+        WS2812b_SetStripPaletteIndex( &ledArray, PALETTE_OFF );
         numRenders = 0;
     }
     return;
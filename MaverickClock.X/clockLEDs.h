@@ -16,6 +16,14 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+/*********************** Macro Definition (s) ****************************/
+#define NUM_CLOCK_PIXELS 64
+#define CLOCK_FACE_WIDTH 14u // Columns
+#define CLOCK_FACE_HEIGHT 5u // Rows
+#define CLOCK_NO_PIXEL 0xFFu // Grid cell with no pixel wired to it
+#define CLOCK_MAX_SWEEP_COLORS 6u // Palette entries set aside for a column sweep's colors
+
+
 /*********************** Type Definition(s) ******************************/
 typedef struct
 {
@@ -25,9 +33,24 @@ typedef struct
     uint8_t digit4; // Ones digit of minutes
 } TimeInDigits;
 
+typedef enum
+{
+    SWEEP_LEFT_TO_RIGHT,
+    SWEEP_RIGHT_TO_LEFT
+} SWEEP_DIRECTION;
+
+/* Column sweep animation, kept in flash. Frame rate is set by the pattern mode table. 
+ * columnMap - pixel indices lit by each column, padded with CLOCK_NO_PIXEL
+ * colors - RGB triplets, one per crossing. Only the first CLOCK_MAX_SWEEP_COLORS are used. */
+typedef struct
+{
+    const uint8_t (*columnMap)[CLOCK_FACE_HEIGHT];
+    uint8_t numColumns;
+    const uint8_t (*colors)[3];
+    uint8_t numColors;
+    SWEEP_DIRECTION direction;
+} ColumnSweepDescriptor;
 
-/*********************** Macro Definition (s) ****************************/
-#define NUM_CLOCK_PIXELS 64
 
 
 
@@ -52,7 +75,8 @@ bool Clock_InitializeClockLEDs(const size_t numElements,
 /* Function: Clock_SetBackgroundRGBArray
  *
  * Description:
- *      Sets local background RGB array. Allows the user to reconfigure colors at runtime.
+ *      Sets the background palette entry. Allows the user to reconfigure colors at runtime. Every
+ *      background pixel takes the color on the next render, nothing is redrawn.
  *
  */
 void Clock_SetBackgroundRGBArray(const uint8_t red,
@@ -62,7 +86,8 @@ void Clock_SetBackgroundRGBArray(const uint8_t red,
 /* Function: Clock_SetDigitRGBArray
  *
  * Description:
- *      Sets local digit RGB array. Allows the user to reconfigure colors at runtime.
+ *      Sets the digit palette entry. Allows the user to reconfigure colors at runtime. Every digit
+ *      pixel takes the color on the next render, nothing is redrawn.
  */
 void Clock_SetDigitRGBArray(const uint8_t red,
         const uint8_t green,
@@ -79,8 +104,8 @@ void Clock_SetDigitRGBArray(const uint8_t red,
  *      minutes value on the screen.
  *
  * Precondition:
- *      Static pixel buffers must have been prerendered, otherwise the screen will only contain
- *      background colors.
+ *      Clock_InitializeClockLEDs must have been called. Digits are expanded from their encodings
+ *      straight into the render buffer as they change.
  */
 void Clock_WriteTimeDigitValuesAndRenderScreen(const TimeInDigits * const digits);
 
@@ -90,12 +115,9 @@ void Clock_WriteTimeDigitValuesAndRenderScreen(const TimeInDigits * const digits
  *      void Clock_PrerenderPixelAndBackgroundValues()
  *
  * Description:
- *      Start by prerendering the background color RGB values to the render buffer entirely.
- *      Iterates through each digit encoding and prerenders the digit values to the statically
- *      allocated digit buffers. This allows the user to simply point to the desired digit at
- *      runtime and copy the values over instead of doing the entire calculation every single
- *      cycle. This function is called once at startup and again for every time the user
- *      changes the desired display colors.
+ *      Points every pixel of the render buffer at the background palette entry. Colors live in the
+ *      palette, so a color change doesn't need this. It clears the face at startup and after a
+ *      pattern, before the digits are written again.
  *
  */
 void Clock_PrerenderPixelAndBackgroundValues(void);
@@ -107,6 +129,7 @@ void Clock_PrerenderPixelAndBackgroundValues(void);
  *
  * Description:
  *      Forces a render based on input TimeInDigits struct. Used primarily in color change mode to force colors to display.
+ *      Writes every digit regardless of the last displayed time, but skips the transmit if the frame is unchanged.
  *
  *
  */
@@ -115,6 +138,41 @@ void Clock_ForceRender(const TimeInDigits * const t);
 
 
 
+/************************************ Geometry functions ***************************/
+/* All lookups index const tables in flash, built from one wiring list at compile time. */
+
+/* Function:
+ *      Clock_GetPixelX / Clock_GetPixelY
+ *
+ * Description:
+ *      Column and row of a pixel index (0-63). Row 0 is the top, column 0 is the left.
+ *      Returns CLOCK_NO_PIXEL for an index past the last pixel.
+ *
+ */
+uint8_t Clock_GetPixelX(const uint8_t pixel);
+uint8_t Clock_GetPixelY(const uint8_t pixel);
+
+/* Function:
+ *      Clock_GetPixelAt
+ *
+ * Description:
+ *      Pixel index at a column and row. Returns CLOCK_NO_PIXEL for an unwired or out of range cell.
+ *
+ */
+uint8_t Clock_GetPixelAt(const uint8_t x,
+        const uint8_t y);
+
+/* Function:
+ *      Clock_GetColumnPixels
+ *
+ * Description:
+ *      The CLOCK_FACE_HEIGHT pixel indices of column x (0 to CLOCK_FACE_WIDTH - 1), top to bottom.
+ *      Unwired cells hold CLOCK_NO_PIXEL. Returns NULL for a column off the face.
+ *
+ */
+const uint8_t * Clock_GetColumnPixels(const uint8_t x);
+
+
 /************************************ Pattern mode functions ***********************/
 
 /* Function:
@@ -127,30 +185,43 @@ void Clock_ForceRender(const TimeInDigits * const t);
 void Clock_IterateSinglePixelByIndex(void);
 
 
-/* Clock_CrossingRainbowPattern
+/* Function:
+ *      Clock_StepColumnSweep
  *
- *      Creates a horizontal, left to right crossing pattern. Changes colors after every final crossing.
+ * Description:
+ *      Draws and renders one frame of a column sweep. Paints the next column of the descriptor's
+ *      column map in the current color, and moves to the next color after every full crossing.
+ *      Restarts from the first column when a different descriptor is passed in, or after
+ *      Clock_RestartColumnSweep.
  *
  */
-void Clock_CrossingRainbowPattern(void);
+void Clock_StepColumnSweep(const ColumnSweepDescriptor * const sweep);
+
 
-/* Clock_CrossingRainbowPatternwithDelays
+/* Function:
+ *      Clock_RestartColumnSweep
+ *
+ * Description:
+ *      Makes the next Clock_StepColumnSweep start from the first column and color, even for the same
+ *      descriptor. Used when two patterns share a descriptor at different frame rates.
  *
- *      Creates rainbow pattern with small time delay
  */
-void Clock_CrossingRainbowPatternwithDelays(void);
+void Clock_RestartColumnSweep(void);
+
+/* Horizontal rainbow crossing over the whole face, left to right */
+extern const ColumnSweepDescriptor Clock_RainbowSweep;
 
 
 /* Clock_Popcorn_Pattern
  *
- * Generates 8 random pixel values at 8 random locations.  
+ * Generates 8 random pixel values at 8 random locations across the whole face.  
  */
 void Clock_Popcorn_Pattern(void);
 
 
 /* Clock_Popcorn_Pattern_Hold
  *
- * Generates 8 random pixel values at 8 random locations. Holds for 8 patterns  
+ * Generates 8 random pixel values at 8 random locations across the whole face. Holds for 8 patterns  
  */
 void Clock_Popcorn_Pattern_Hold(void);
 
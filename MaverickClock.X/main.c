@@ -10,6 +10,7 @@ void main( void )
     while( 1 )
     {
         APP_TASKS( );
+        APP_WaitForEvent( );
     }
     return;
 }
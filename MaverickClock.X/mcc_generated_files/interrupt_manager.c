@@ -66,6 +66,10 @@ void __interrupt() INTERRUPT_InterruptManager (void)
         {
             TMR1_ISR();
         } 
+        else if(PIE3bits.TMR3IE == 1 && PIR3bits.TMR3IF == 1)
+        {
+            TMR3_ISR();
+        } 
         else
         {
             //Unhandled Interrupt
@@ -55,6 +55,7 @@
   Section: Global Variables Definitions
 */
 volatile uint16_t timer3ReloadVal;
+static volatile uint16_t timer3OverflowCount;
 
 /**
   Section: TMR3 APIs
@@ -73,12 +74,18 @@ void TMR3_Initialize(void)
     //TMR3L 49; 
     TMR3L = 0x31;
 
-    // Clearing IF flag.
+    // Clearing IF flag before enabling the interrupt.
     PIR3bits.TMR3IF = 0;
 	
     // Load the TMR value to reload variable
     timer3ReloadVal=(uint16_t)((TMR3H << 8) | TMR3L);
 
+    // Upper half of the extended timebase
+    timer3OverflowCount = 0;
+
+    // Enabling TMR3 interrupt.
+    PIE3bits.TMR3IE = 1;
+
     // T3CKPS 1:8; T3SOSC T3CKI_enabled; T3SYNC do_not_synchronize; TMR3CS LFINTOSC; TMR3ON enabled; 
     T3CON = 0xF5;
 }
@@ -152,6 +159,41 @@ bool TMR3_HasOverflowOccured(void)
     // check if  overflow has occurred by checking the TMRIF bit
     return(PIR3bits.TMR3IF);
 }
+
+void TMR3_ISR(void)
+{
+    // Clear the TMR3 interrupt flag
+    PIR3bits.TMR3IF = 0;
+
+    // The timer free runs through the full 16 bits and is not reloaded, the overflow count carries
+    // the upper half of the extended timebase
+    timer3OverflowCount++;
+}
+
+uint32_t TMR3_ReadExtendedTimer(void)
+{
+    uint16_t overflowCount;
+    uint16_t timerVal;
+
+    // Mask only this interrupt so the count and the register are read as a pair
+    uint8_t isInterruptEnabled = PIE3bits.TMR3IE;
+    PIE3bits.TMR3IE = 0;
+
+    overflowCount = timer3OverflowCount;
+    timerVal = TMR3_ReadTimer();
+
+    // Wrapped but not serviced yet, because it was masked or this was called from another ISR. A
+    // low count means the register was read after the wrap, so it belongs to the next overflow.
+    if((1u == PIR3bits.TMR3IF) && (timerVal < 0x8000u))
+    {
+        overflowCount++;
+    }
+
+    PIE3bits.TMR3IE = isInterruptEnabled;
+
+    return ((uint32_t)overflowCount << 16) | timerVal;
+}
+
 /**
   End of File
 */
@@ -386,6 +386,45 @@ uint8_t TMR3_CheckGateValueStatus(void);
 */
 bool TMR3_HasOverflowOccured(void);
 
+/**
+  @Summary
+    Timer Interrupt Service Routine
+
+  @Description
+    Timer Interrupt Service Routine is called by the Interrupt Manager. Counts overflows to extend
+    the timer to 32 bits.
+
+  @Preconditions
+    Initialize  the TMR3 module with interrupt before calling this ISR.
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void TMR3_ISR(void);
+
+/**
+  @Summary
+    Reads the 32 bit extended timer
+
+  @Description
+    Combines the overflow count kept by TMR3_ISR with the TMR3 register into a monotonic
+    timestamp. Wraps after about 12 days instead of every 17 s. Safe to call from the main loop or
+    from another ISR, an overflow that is pending but not yet serviced is accounted for.
+
+  @Preconditions
+    Initialize  the TMR3 module with interrupt before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    Timer counts since TMR3_Initialize
+*/
+uint32_t TMR3_ReadExtendedTimer(void);
+
 #ifdef __cplusplus  // Provide C++ Compatibility
 
     }
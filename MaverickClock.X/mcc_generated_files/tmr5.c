@@ -55,6 +55,7 @@
   Section: Global Variables Definitions
 */
 volatile uint16_t timer5ReloadVal;
+static uint8_t timer5MissedPeriods;
 void (*TMR5_InterruptHandler)(void);
 
 /**
@@ -159,13 +160,33 @@ void TMR5_ISR(void)
 
     // Clear the TMR5 interrupt flag
     PIR4bits.TMR5IF = 0;
-    TMR5_WriteTimer(timer5ReloadVal);
+
+    // Counts since the overflow. A few at most, unless interrupts were masked for longer than a
+    // period. Keep the remainder so the ISR latency is not lost, and count the whole periods.
+    uint16_t elapsedCounts = TMR5_ReadTimer();
+    uint16_t periodCounts = (uint16_t)(0u - timer5ReloadVal);
+    while(elapsedCounts >= periodCounts)
+    {
+        elapsedCounts -= periodCounts;
+        if(timer5MissedPeriods < 0xFFu)
+        {
+            timer5MissedPeriods++;
+        }
+    }
+    TMR5_WriteTimer(timer5ReloadVal + elapsedCounts);
 
     // ticker function call;
     // ticker is 1 -> Callback function gets called everytime this ISR executes
     TMR5_CallBack();
 }
 
+uint8_t TMR5_TakeMissedPeriods(void)
+{
+    uint8_t missedPeriods = timer5MissedPeriods;
+    timer5MissedPeriods = 0;
+    return missedPeriods;
+}
+
 void TMR5_CallBack(void)
 {
     // Add your custom callback code here
@@ -366,6 +366,26 @@ uint8_t TMR5_CheckGateValueStatus(void);
     None
 */
 void TMR5_ISR(void);
+
+/**
+  @Summary
+    Returns and clears the number of whole timer periods that elapsed before TMR5_ISR ran
+
+  @Description
+    TMR5_ISR reloads the timer with the counts that elapsed since the overflow kept, so a late
+    interrupt doesn't shift the period. Counts beyond a full period are periods whose overflow was
+    never serviced. They are recorded here so the callback can credit them.
+
+  @Preconditions
+    Call only from the TMR5 interrupt callback.
+
+  @Param
+    None
+
+  @Returns
+    Number of missed periods, saturating at 255
+*/
+uint8_t TMR5_TakeMissedPeriods(void);
 /**
   @Summary
     CallBack function.
@@ -420,6 +440,12 @@ void TMR5_CallBack(void);
 */
 extern void (*TMR5_InterruptHandler)(void);
 
+/**
+  @Summary
+    Value written to the timer on every overflow. Set by TMR5_Initialize.
+*/
+extern volatile uint16_t timer5ReloadVal;
+
 /**
   @Summary
     Default Timer Interrupt Handler
@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=mcc_generated_files/pin_manager.c mcc_generated_files/device_config.c mcc_generated_files/tmr1.c mcc_generated_files/mcc.c mcc_generated_files/interrupt_manager.c mcc_generated_files/tmr3.c mcc_generated_files/tmr5.c mcc_generated_files/memory.c patternMode.c changeColorMode.c timeCalculation.c main.c ws2812b.c rotaryEncoder.c app.c clockLEDs.c CRC16bit.c nvmMirror.c
+SOURCEFILES_QUOTED_IF_SPACED=mcc_generated_files/pin_manager.c mcc_generated_files/device_config.c mcc_generated_files/tmr1.c mcc_generated_files/mcc.c mcc_generated_files/interrupt_manager.c mcc_generated_files/tmr3.c mcc_generated_files/tmr5.c mcc_generated_files/memory.c patternMode.c changeColorMode.c timeCalculation.c main.c ws2812b.c rotaryEncoder.c app.c clockLEDs.c CRC16bit.c nvmMirror.c prng.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/mcc_generated_files/pin_manager.p1 ${OBJECTDIR}/mcc_generated_files/device_config.p1 ${OBJECTDIR}/mcc_generated_files/tmr1.p1 ${OBJECTDIR}/mcc_generated_files/mcc.p1 ${OBJECTDIR}/mcc_generated_files/interrupt_manager.p1 ${OBJECTDIR}/mcc_generated_files/tmr3.p1 ${OBJECTDIR}/mcc_generated_files/tmr5.p1 ${OBJECTDIR}/mcc_generated_files/memory.p1 ${OBJECTDIR}/patternMode.p1 ${OBJECTDIR}/changeColorMode.p1 ${OBJECTDIR}/timeCalculation.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/ws2812b.p1 ${OBJECTDIR}/rotaryEncoder.p1 ${OBJECTDIR}/app.p1 ${OBJECTDIR}/clockLEDs.p1 ${OBJECTDIR}/CRC16bit.p1 ${OBJECTDIR}/nvmMirror.p1
-POSSIBLE_DEPFILES=${OBJECTDIR}/mcc_generated_files/pin_manager.p1.d ${OBJECTDIR}/mcc_generated_files/device_config.p1.d ${OBJECTDIR}/mcc_generated_files/tmr1.p1.d ${OBJECTDIR}/mcc_generated_files/mcc.p1.d ${OBJECTDIR}/mcc_generated_files/interrupt_manager.p1.d ${OBJECTDIR}/mcc_generated_files/tmr3.p1.d ${OBJECTDIR}/mcc_generated_files/tmr5.p1.d ${OBJECTDIR}/mcc_generated_files/memory.p1.d ${OBJECTDIR}/patternMode.p1.d ${OBJECTDIR}/changeColorMode.p1.d ${OBJECTDIR}/timeCalculation.p1.d ${OBJECTDIR}/main.p1.d ${OBJECTDIR}/ws2812b.p1.d ${OBJECTDIR}/rotaryEncoder.p1.d ${OBJECTDIR}/app.p1.d ${OBJECTDIR}/clockLEDs.p1.d ${OBJECTDIR}/CRC16bit.p1.d ${OBJECTDIR}/nvmMirror.p1.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/mcc_generated_files/pin_manager.p1 ${OBJECTDIR}/mcc_generated_files/device_config.p1 ${OBJECTDIR}/mcc_generated_files/tmr1.p1 ${OBJECTDIR}/mcc_generated_files/mcc.p1 ${OBJECTDIR}/mcc_generated_files/interrupt_manager.p1 ${OBJECTDIR}/mcc_generated_files/tmr3.p1 ${OBJECTDIR}/mcc_generated_files/tmr5.p1 ${OBJECTDIR}/mcc_generated_files/memory.p1 ${OBJECTDIR}/patternMode.p1 ${OBJECTDIR}/changeColorMode.p1 ${OBJECTDIR}/timeCalculation.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/ws2812b.p1 ${OBJECTDIR}/rotaryEncoder.p1 ${OBJECTDIR}/app.p1 ${OBJECTDIR}/clockLEDs.p1 ${OBJECTDIR}/CRC16bit.p1 ${OBJECTDIR}/nvmMirror.p1 ${OBJECTDIR}/prng.p1
+POSSIBLE_DEPFILES=${OBJECTDIR}/mcc_generated_files/pin_manager.p1.d ${OBJECTDIR}/mcc_generated_files/device_config.p1.d ${OBJECTDIR}/mcc_generated_files/tmr1.p1.d ${OBJECTDIR}/mcc_generated_files/mcc.p1.d ${OBJECTDIR}/mcc_generated_files/interrupt_manager.p1.d ${OBJECTDIR}/mcc_generated_files/tmr3.p1.d ${OBJECTDIR}/mcc_generated_files/tmr5.p1.d ${OBJECTDIR}/mcc_generated_files/memory.p1.d ${OBJECTDIR}/patternMode.p1.d ${OBJECTDIR}/changeColorMode.p1.d ${OBJECTDIR}/timeCalculation.p1.d ${OBJECTDIR}/main.p1.d ${OBJECTDIR}/ws2812b.p1.d ${OBJECTDIR}/rotaryEncoder.p1.d ${OBJECTDIR}/app.p1.d ${OBJECTDIR}/clockLEDs.p1.d ${OBJECTDIR}/CRC16bit.p1.d ${OBJECTDIR}/nvmMirror.p1.d ${OBJECTDIR}/prng.p1.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/mcc_generated_files/pin_manager.p1 ${OBJECTDIR}/mcc_generated_files/device_config.p1 ${OBJECTDIR}/mcc_generated_files/tmr1.p1 ${OBJECTDIR}/mcc_generated_files/mcc.p1 ${OBJECTDIR}/mcc_generated_files/interrupt_manager.p1 ${OBJECTDIR}/mcc_generated_files/tmr3.p1 ${OBJECTDIR}/mcc_generated_files/tmr5.p1 ${OBJECTDIR}/mcc_generated_files/memory.p1 ${OBJECTDIR}/patternMode.p1 ${OBJECTDIR}/changeColorMode.p1 ${OBJECTDIR}/timeCalculation.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/ws2812b.p1 ${OBJECTDIR}/rotaryEncoder.p1 ${OBJECTDIR}/app.p1 ${OBJECTDIR}/clockLEDs.p1 ${OBJECTDIR}/CRC16bit.p1 ${OBJECTDIR}/nvmMirror.p1
+OBJECTFILES=${OBJECTDIR}/mcc_generated_files/pin_manager.p1 ${OBJECTDIR}/mcc_generated_files/device_config.p1 ${OBJECTDIR}/mcc_generated_files/tmr1.p1 ${OBJECTDIR}/mcc_generated_files/mcc.p1 ${OBJECTDIR}/mcc_generated_files/interrupt_manager.p1 ${OBJECTDIR}/mcc_generated_files/tmr3.p1 ${OBJECTDIR}/mcc_generated_files/tmr5.p1 ${OBJECTDIR}/mcc_generated_files/memory.p1 ${OBJECTDIR}/patternMode.p1 ${OBJECTDIR}/changeColorMode.p1 ${OBJECTDIR}/timeCalculation.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/ws2812b.p1 ${OBJECTDIR}/rotaryEncoder.p1 ${OBJECTDIR}/app.p1 ${OBJECTDIR}/clockLEDs.p1 ${OBJECTDIR}/CRC16bit.p1 ${OBJECTDIR}/nvmMirror.p1 ${OBJECTDIR}/prng.p1
 
 # Source Files
-SOURCEFILES=mcc_generated_files/pin_manager.c mcc_generated_files/device_config.c mcc_generated_files/tmr1.c mcc_generated_files/mcc.c mcc_generated_files/interrupt_manager.c mcc_generated_files/tmr3.c mcc_generated_files/tmr5.c mcc_generated_files/memory.c patternMode.c changeColorMode.c timeCalculation.c main.c ws2812b.c rotaryEncoder.c app.c clockLEDs.c CRC16bit.c nvmMirror.c
+SOURCEFILES=mcc_generated_files/pin_manager.c mcc_generated_files/device_config.c mcc_generated_files/tmr1.c mcc_generated_files/mcc.c mcc_generated_files/interrupt_manager.c mcc_generated_files/tmr3.c mcc_generated_files/tmr5.c mcc_generated_files/memory.c patternMode.c changeColorMode.c timeCalculation.c main.c ws2812b.c rotaryEncoder.c app.c clockLEDs.c CRC16bit.c nvmMirror.c prng.c
 
 
 
@@ -238,6 +238,14 @@ ${OBJECTDIR}/nvmMirror.p1: nvmMirror.c  nbproject/Makefile-${CND_CONF}.mk
 	@-${MV} ${OBJECTDIR}/nvmMirror.d ${OBJECTDIR}/nvmMirror.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/nvmMirror.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/prng.p1: prng.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/prng.p1.d 
+	@${RM} ${OBJECTDIR}/prng.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit4   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O1 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-2 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mkeep-startup -mno-osccal -mresetbits -msave-resetbits -mno-download -mno-stackcall -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/prng.p1 prng.c 
+	@-${MV} ${OBJECTDIR}/prng.d ${OBJECTDIR}/prng.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/prng.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 else
 ${OBJECTDIR}/mcc_generated_files/pin_manager.p1: mcc_generated_files/pin_manager.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}/mcc_generated_files" 
@@ -383,6 +391,14 @@ ${OBJECTDIR}/nvmMirror.p1: nvmMirror.c  nbproject/Makefile-${CND_CONF}.mk
 	@-${MV} ${OBJECTDIR}/nvmMirror.d ${OBJECTDIR}/nvmMirror.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/nvmMirror.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/prng.p1: prng.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/prng.p1.d 
+	@${RM} ${OBJECTDIR}/prng.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -O1 -fasmfile -maddrqual=ignore -xassembler-with-cpp -mwarn=-2 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mkeep-startup -mno-osccal -mresetbits -msave-resetbits -mno-download -mno-stackcall -mdefault-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/prng.p1 prng.c 
+	@-${MV} ${OBJECTDIR}/prng.d ${OBJECTDIR}/prng.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/prng.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 endif
 
 # ------------------------------------------------------------------------------------
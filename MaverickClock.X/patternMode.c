@@ -13,15 +13,40 @@
 #include "patternMode.h"
 #include "clockLEDs.h"
 #include "rotaryEncoder.h"
+#include "prng.h"
+#include "mcc_generated_files/tmr3.h"
 
 
 /*********************** Macro Definition (s) ****************************/
 #define NUM_PATTERNS 5u
 #define limit(val, low, high) ( (val < low) ? high : (val > high) ? low : val)
 
+/* TMR3 runs from LFINTOSC / 8, 3875 counts per second */
+#define TMR3_COUNTS_PER_SECOND 3875u
+#define FRAME_PERIOD_MS_TO_CTS(ms) ( (uint16_t) ( ( (uint32_t) (ms) * TMR3_COUNTS_PER_SECOND ) / 1000u ) )
+
+
+/*********************** Type Definition(s) *****************************/
+/* One pattern: either a step function drawing and rendering a single frame, or a column sweep run by
+ * the sweep engine, plus the time between frames. A period of 0 steps on every pass through the main loop. */
+typedef struct
+{
+    void (*step)(void);
+    const ColumnSweepDescriptor * sweep; // Used when step is NULL
+    uint16_t framePeriod_cts;
+} PatternDescriptor;
+
 
 /*********************** Local Variables (s) ****************************/
-static void (*patterns[NUM_PATTERNS])(void);
+static const PatternDescriptor patterns[NUM_PATTERNS] = {
+    {Clock_IterateSinglePixelByIndex, NULL, FRAME_PERIOD_MS_TO_CTS( 50u )},
+    {NULL, &Clock_RainbowSweep, FRAME_PERIOD_MS_TO_CTS( 0u )},
+    {NULL, &Clock_RainbowSweep, FRAME_PERIOD_MS_TO_CTS( 75u )},
+    {Clock_Popcorn_Pattern, NULL, FRAME_PERIOD_MS_TO_CTS( 150u )},
+    {Clock_Popcorn_Pattern_Hold, NULL, FRAME_PERIOD_MS_TO_CTS( 150u )}
+};
+
+static uint32_t nextFrameDeadline_cts = 0u;
 
 
 
@@ -34,22 +59,38 @@ void STATE_PatternMode(void)
     // array index determines function pointer to call.
     static int32_t patternIndex = 0;
     int32_t rotCounts = RotaryEncoder_GetShaftCounts();
+    uint32_t now_cts = TMR3_ReadExtendedTimer();
 
     if (rotCounts)
     {
         patternIndex += rotCounts;
         patternIndex = limit( patternIndex, 0,NUM_PATTERNS-1 );
+        Clock_RestartColumnSweep( ); // The rainbow patterns share a descriptor, don't resume mid sweep
+        nextFrameDeadline_cts = now_cts; // Show the new pattern straight away
+        PRNG_Seed( (uint16_t) now_cts ); // When the user turns the knob is the only entropy available
     }
 
-    (*patterns[patternIndex])();
-    return;
-}
+    /* Signed difference handles the extended timer wrapping */
+    if ( (int32_t) ( now_cts - nextFrameDeadline_cts ) < 0 )
+    {
+        return;
+    }
 
-void State_SetFunctionLookupTable(void)
-{
-    patterns[0] = Clock_IterateSinglePixelByIndex;
-    patterns[1] = Clock_CrossingRainbowPattern;
-    patterns[2] = Clock_CrossingRainbowPatternwithDelays;
-    patterns[3] = Clock_Popcorn_Pattern;
-    patterns[4] = Clock_Popcorn_Pattern_Hold;
+    if ( NULL == patterns[patternIndex].step )
+    {
+        Clock_StepColumnSweep( patterns[patternIndex].sweep );
+    }
+    else
+    {
+        (*patterns[patternIndex].step)();
+    }
+
+    /* Keep a steady frame rate, unless the deadline has fallen more than a frame behind (first entry
+     * into pattern mode, or a long frame). Then restart the schedule from now instead of catching up. */
+    nextFrameDeadline_cts += patterns[patternIndex].framePeriod_cts;
+    if ( (int32_t) ( now_cts - nextFrameDeadline_cts ) >= 0 )
+    {
+        nextFrameDeadline_cts = now_cts + patterns[patternIndex].framePeriod_cts;
+    }
+    return;
 }
@@ -18,24 +18,15 @@
  *      STATE_PatternMode
  *
  * Description:
- *      Entry point to pattern mode. Calls the 
+ *      Entry point to pattern mode. Selects the pattern from the encoder counts and calls its step
+ *      function once the pattern's frame period has passed on TMR3. Never blocks, so it returns to
+ *      the main loop straight away between frames.
  * 
  */
 void STATE_PatternMode(void);
 
 
 
-/* Function:
- *      State_SetFunctionLookupTable()
- * 
- * Description:
- *      Sets the local static function lookup table. 
- * 
- */
-void State_SetFunctionLookupTable(void);
-
-
-
 
 
 #endif 
@@ -0,0 +1,41 @@
+/* Filename: prng.c
+ * 
+ * Description: 16 bit xorshift pseudo random number generator using the (7, 9, 8) shift
+ *      triplet. Each step is three shifts and three XORs on a 16 bit state, far cheaper 
+ *      on the PIC than the 32 bit multiply behind libc rand(). Not suitable for anything 
+ *      but visual effects. 
+ * 
+ */
+
+/**************  Included Files **************************/
+#include "prng.h"
+
+/**************  Macro Definitions ***********************/
+#define PRNG_DEFAULT_SEED 0xACE1u
+
+
+/**************  Local Variables *************************/
+static uint16_t prngState = PRNG_DEFAULT_SEED;
+
+
+/**************  Function Definitions ********************/
+void PRNG_Seed( const uint16_t seed )
+{
+    prngState = ( 0u == seed ) ? PRNG_DEFAULT_SEED : seed;
+    return;
+}
+
+uint16_t PRNG_Next16( void )
+{
+    prngState ^= prngState << 7u;
+    prngState ^= prngState >> 9u;
+    prngState ^= prngState << 8u;
+    return prngState;
+}
+
+uint8_t PRNG_Next8( void )
+{
+    return (uint8_t) ( PRNG_Next16( ) >> 8u );
+}
+
+/* End of prng.c source file */
@@ -0,0 +1,44 @@
+/* 
+ * Filename: prng.h
+ * 
+ * Description: Function declarations for the 16 bit xorshift pseudo random number generator
+ *      used by pattern effects.
+ * 
+ * 
+ */
+
+#ifndef PRNG_H
+#define PRNG_H
+
+/**************  Included File(s) **************************/
+#include <stdint.h>
+
+/**************  Function Prototype(s) *********************/
+
+/* Function:
+ *      PRNG_Seed
+ *
+ * Description:
+ *      Sets the generator state. A zero seed would lock the generator at zero, so it is replaced
+ *      with the default seed.
+ */
+void PRNG_Seed(const uint16_t seed);
+
+/* Function:
+ *      PRNG_Next16
+ *
+ * Description:
+ *      Advances the generator and returns the full 16 bit state. Period is 65535.
+ */
+uint16_t PRNG_Next16(void);
+
+/* Function:
+ *      PRNG_Next8
+ *
+ * Description:
+ *      Advances the generator and returns its high byte.
+ */
+uint8_t PRNG_Next8(void);
+
+#endif
+/* End of prng.h header file */
@@ -10,9 +10,10 @@
  *      rotary encoders per project won't work. Each instance of a rotary encoder
  *      requires a different file or at least more functions added for each encoder. 
  * 
- *      Rotary encoder module is linked to the TIMER3 module, and the timer3 callback and 
- *      enable/disable are handled in this module. Timer3 is currently configured with a 
- *      129uS per register increment resolution. 
+ *      Rotary encoder timestamps come from the TIMER3 module, extended to 32 bits by its 
+ *      overflow interrupt so intervals stay correct across the 16 bit wrap. Timer3 is the 
+ *      system clock and free runs, it is never stopped here. Timer3 is currently configured 
+ *      with a 258uS per register increment resolution. 
  * 
  *      The CyleWet KY-040 uses 3 pins (CLK, DT, and SW). The inputs to the microcontroller
  *      are all active high. 
@@ -25,14 +26,51 @@
 #include "mcc_generated_files/pin_manager.h"
 #include "mcc_generated_files/tmr3.h"
 
+/********************** Macro Definition(s) ********/
+/* Acceleration curve resolution. Detent intervals are bucketed by 32 TMR3 counts, about 8 ms at the
+ * 258 us per count the button thresholds in app.c are based on. */
+#define ACCELERATION_INTERVAL_SHIFT 5u
+#define NUM_ACCELERATION_STEPS 8u
+
+/* Marks a transition where both pins changed, so the direction is unknown */
+#define QUADRATURE_INVALID ((int8_t) 0x7F)
+
+/* Intervals are measured per count, scale them back up to a full detent before the curve lookup */
+#if ( ROT_ENC_COUNTS_PER_DETENT == 4 )
+#define COUNTS_PER_DETENT_SHIFT 2u
+#elif ( ROT_ENC_COUNTS_PER_DETENT == 2 )
+#define COUNTS_PER_DETENT_SHIFT 1u
+#else
+#define COUNTS_PER_DETENT_SHIFT 0u
+#endif
+
+
 /********************** Local Variable(s) **********/
 static volatile RotaryEncoder * rot;
 static bool isRotaryEncoderEnabled = false;
+static void (*RotaryEncoder_EventHandler)( void ) = NULL; // Called by both ISRs on every edge
+
+/* Counts added per detent, indexed by detent interval >> ACCELERATION_INTERVAL_SHIFT. Anything slower
+ * than the last entry counts as 1. Under 8 ms per detent is a hard spin, over 33 ms is a deliberate turn. */
+static const uint8_t accelerationCurve[NUM_ACCELERATION_STEPS] = {8u, 5u, 3u, 2u, 1u, 1u, 1u, 1u};
+
+/* Direction of every (last, current) pin transition, indexed by the shaft vector. Repeated states decode
+ * to 0, skipped states to QUADRATURE_INVALID. */
+static const int8_t quadratureTable[16] = 
+{
+     0,  1, -1, QUADRATURE_INVALID,
+    -1,  0, QUADRATURE_INVALID,  1,
+     1, QUADRATURE_INVALID,  0, -1,
+     QUADRATURE_INVALID, -1,  1,  0
+};
 
 
 /*************** Local Function Prototype(s) *******/
 static void RotaryEncoder_ReadShaftISR( void );
 static void RotaryEncoder_ReadButtonISR( void );
+static uint8_t RotaryEncoder_GetDetentStep( void );
+static void RotaryEncoder_PostButtonEvent( const RotarySwitchState state,
+                                           const uint32_t timestamp_cts );
 
 /******************** Public Functions *************/
 
@@ -50,75 +88,109 @@ bool RotaryEncoder_Init( RotaryEncoder * const rotEncPtr )
     return true;
 }
 
+void RotaryEncoder_SetEventHandler( void (* eventHandler)( void ) )
+{
+    RotaryEncoder_EventHandler = eventHandler;
+    return;
+}
+
 void RotaryEncoder_Enable( void )
 {
     rot->shaft.counts = 0u;
+    rot->shaft.lastSeenCounts = 0u;
     rot->shaft.vector = 0u;
-    rot->shaft.currentTimestamp_tr = TMR3_ReadTimer( );
-    rot->shaft.velocity_tps = 0u;
+    rot->shaft.quarterSteps = 0;
+    rot->shaft.invalidTransitionCount = 0u;
+    rot->shaft.currentTimestamp_tr = TMR3_ReadExtendedTimer( );
+    rot->shaft.detentInterval_cts = 0xFFFFu;
 
-    rot->rotBtn.currentState = SWITCH_RESTING;
     rot->rotBtn.lastFallingEdgeTimestamp_cts = 0u;
     rot->rotBtn.lastRisingEdgeTimestamp_cts = 0u;
     rot->rotBtn.currentNumMulticlicks = 0;
-    rot->rotBtn.hasSwitchBeenPressed = false;
+    rot->rotBtn.eventHead = 0u;
+    rot->rotBtn.eventTail = 0u;
+    rot->rotBtn.eventOverflowCount = 0u;
 
-    TMR3_StartTimer( );
     isRotaryEncoderEnabled = true;
 }
 
 void RotaryEncoder_Disable( void )
 {
-    TMR3_StopTimer( );
-    isRotaryEncoderEnabled = false;
+    isRotaryEncoderEnabled = false; // TMR3 is left running, it is the system timebase
 }
 
 int32_t RotaryEncoder_GetShaftCounts( void )
 {
-    volatile int32_t thisCountValue = rot->shaft.counts;
-    rot->shaft.counts = 0;
-    return thisCountValue;
+    uint16_t thisCountValue;
+    do
+    {
+        thisCountValue = rot->shaft.counts; // Two byte read, the ISR may update it in between
+    } while( thisCountValue != rot->shaft.counts );
+
+    int16_t delta = (int16_t) ( thisCountValue - rot->shaft.lastSeenCounts ); // Wraps correctly across 65535 -> 0
+    rot->shaft.lastSeenCounts = thisCountValue;
+    return delta;
 }
 
-RotarySwitchState RotaryEncoder_GetSwitchState( void )
+uint8_t RotaryEncoder_GetInvalidTransitionCount( void )
 {
-    RotarySwitchState currentState = rot->rotBtn.currentState;
-    rot->rotBtn.currentState = SWITCH_RESTING;
-
-    return currentState;
+    return rot->shaft.invalidTransitionCount;
 }
 
-bool RotaryEncoder_HasButtonPressOccurred( void )
+bool RotaryEncoder_GetButtonEvent( RotaryButtonEvent * const event )
 {
-    if( rot->rotBtn.hasSwitchBeenPressed )
-    {
-        rot->rotBtn.hasSwitchBeenPressed = false;
-        return true;
-    }
-    else
+    uint8_t tail = rot->rotBtn.eventTail;
+    if( tail == rot->rotBtn.eventHead )
     {
         return false;
     }
+
+    event->state = rot->rotBtn.events[tail & ROT_BTN_EVENT_QUEUE_MASK].state;
+    event->timestamp_cts = rot->rotBtn.events[tail & ROT_BTN_EVENT_QUEUE_MASK].timestamp_cts;
+    rot->rotBtn.eventTail = tail + 1u; // Hands the slot back to the ISR
+    return true;
+}
+
+bool RotaryEncoder_HasButtonPressOccurred( void )
+{
+    RotaryButtonEvent discardedEvent;
+    return RotaryEncoder_GetButtonEvent( &discardedEvent );
+}
+
+void RotaryEncoder_FlushButtonEvents( void )
+{
+    rot->rotBtn.eventTail = rot->rotBtn.eventHead;
+    return;
+}
+
+uint8_t RotaryEncoder_GetButtonEventOverflowCount( void )
+{
+    return rot->rotBtn.eventOverflowCount;
 }
 
 
 /*********************** Private Function(s) *******************/
 
 /* Function: 
- *      RotaryEncoder_Read
+ *      RotaryEncoder_ReadShaftISR
  * 
  * Description: 
- *      Reads the states of the rotary encoder pins and changes the counts based on the velocity and direction. 
+ *      Reads the states of the rotary encoder pins and decodes the transition through quadratureTable. Reports a
+ *      count, scaled by the acceleration curve, each time ROT_ENC_COUNTS_PER_DETENT says a count is complete.
  * 
- * Rotary vector format: 0b0000 (Last CK) (Last DT) (Current CK) (Current DT)
+ * Rotary vector format: 0b0000 (Last DT) (Last CK) (Current DT) (Current CK)
  * Based on above vector format and read pins on change interrupt, every vector will go in this order:
- *      CW Order: 11->6->13->10->4->9->2->5
- *     CCW Order: 7-15->14->12->8->0->1->3
- * Select the count incrementer value based on the desired pulses per detent.  
+ *      CW Order: 1->7->14->8
+ *     CCW Order: 2->11->13->4
+ * 8 and 4 arrive at the resting state, 0b00.
  * 
  */
 static void RotaryEncoder_ReadShaftISR( void )
 {
+    if( RotaryEncoder_EventHandler )
+    {
+        RotaryEncoder_EventHandler( );
+    }
     if( isRotaryEncoderEnabled )
     {
         /* Perserve old rotary encoder values */
@@ -128,27 +200,75 @@ static void RotaryEncoder_ReadShaftISR( void )
         rot->shaft.vector |= ( ROT_DT_GetValue( ) ) ? 0x2u : 0x0u; 
         rot->shaft.vector |= ( ROT_CLK_GetValue( ) ) ? 0x1u : 0x0u;
 
-        /* Save current direction */
-        ROTARY_ENCODER_DIRECTION currentDirection = rot->shaft.currentDirection;
+        int8_t transition = quadratureTable[rot->shaft.vector];
+        if( QUADRATURE_INVALID == transition )
+        {
+            if( rot->shaft.invalidTransitionCount < 0xFFu )
+            {
+                rot->shaft.invalidTransitionCount++;
+            }
+            return;
+        }
+        rot->shaft.quarterSteps += transition;
 
-        /* Convert last and current pin state vector to counts */
-        switch( rot->shaft.vector )
+        /* Wait for the state that completes a count, then report the net direction since the last one */
+#if ( ROT_ENC_COUNTS_PER_DETENT == 1 )
+        if( 0b00u != ( rot->shaft.vector & 0b0011u ) )
         {
-            case 0b1000: // Clockwise case
-                rot->shaft.counts++;
-                rot->shaft.currentDirection = ROT_ENC_CW_DIR;
-                break;
-            case 0b0100: // Counter clockwise case 
-                rot->shaft.counts--;
-                rot->shaft.currentDirection = ROT_ENC_CCW_DIR;
-                break;
-            default:
-                break;
+            return;
         }
+#elif ( ROT_ENC_COUNTS_PER_DETENT == 2 )
+        if( ( 0b01u == ( rot->shaft.vector & 0b0011u ) ) || ( 0b10u == ( rot->shaft.vector & 0b0011u ) ) )
+        {
+            return;
+        }
+#endif
+
+        if( rot->shaft.quarterSteps > 0 )
+        {
+            rot->shaft.counts += RotaryEncoder_GetDetentStep( );
+            rot->shaft.currentDirection = ROT_ENC_CW_DIR;
+        }
+        else if( rot->shaft.quarterSteps < 0 )
+        {
+            rot->shaft.counts -= RotaryEncoder_GetDetentStep( );
+            rot->shaft.currentDirection = ROT_ENC_CCW_DIR;
+        }
+        rot->shaft.quarterSteps = 0;
     }
     return;
 }
 
+/*
+ * Function:         
+ *      RotaryEncoder_GetDetentStep
+ *
+ * Description: 
+ *      Called from the shaft ISR on every detent. Measures the time since the previous detent with TMR3 and
+ *      looks up the step size for that speed in the acceleration curve. Intervals longer than 16 bits are
+ *      clamped, they are far slower than the curve anyway, and a shift replaces any division.
+ * 
+ */
+static uint8_t RotaryEncoder_GetDetentStep( void )
+{
+    uint32_t currentTimestamp = TMR3_ReadExtendedTimer( );
+    uint32_t interval = currentTimestamp - rot->shaft.currentTimestamp_tr;
+    rot->shaft.detentInterval_cts = ( interval > 0xFFFFu ) ? 0xFFFFu : (uint16_t) interval;
+    rot->shaft.currentTimestamp_tr = currentTimestamp;
+
+    if( !rot->shaft.config.isAccelerationEnabled )
+    {
+        return 1u;
+    }
+
+    uint16_t curveIndex = rot->shaft.detentInterval_cts >> ( ACCELERATION_INTERVAL_SHIFT - COUNTS_PER_DETENT_SHIFT );
+    if( curveIndex >= NUM_ACCELERATION_STEPS )
+    {
+        return 1u;
+    }
+    return accelerationCurve[curveIndex];
+}
+
 /*
  * Function:         
  *      RotaryEncoder_ReadButtonISR
@@ -160,11 +280,15 @@ static void RotaryEncoder_ReadShaftISR( void )
  */
 static void RotaryEncoder_ReadButtonISR( void )
 {
+    if( RotaryEncoder_EventHandler )
+    {
+        RotaryEncoder_EventHandler( );
+    }
     if( true == isRotaryEncoderEnabled )
     {
         /* Get the current timestamp */
-        uint16_t currentTimestamp = TMR3_ReadTimer( );
-        uint16_t positiveWidth_cts;
+        uint32_t currentTimestamp = TMR3_ReadExtendedTimer( );
+        uint32_t positiveWidth_cts;
 
         /* Get the pin pressed state */
         switch( ROT_SW_GetValue( ) )
@@ -178,23 +302,22 @@ static void RotaryEncoder_ReadButtonISR( void )
                 /* Check for a long press condition. Long press takes priority over multi click */
                 if( positiveWidth_cts > rot->rotBtn.config.longPressTimerThreshold_cts )
                 {
-                    rot->rotBtn.currentState = SWITCH_HOLD;
+                    RotaryEncoder_PostButtonEvent( SWITCH_HOLD, currentTimestamp );
                 }
 
                     /* Check for double click condition. Last two falling edges were ~350ms apart. */
                 else if( currentTimestamp - rot->rotBtn.lastFallingEdgeTimestamp_cts < rot->rotBtn.config.multiClickTimerThreshold_cts )
                 {
                     rot->rotBtn.currentNumMulticlicks++;
-                    rot->rotBtn.currentState = SWITCH_DOUBLE_CLICK;
+                    RotaryEncoder_PostButtonEvent( SWITCH_DOUBLE_CLICK, currentTimestamp );
                 }
 
                 else
                 {
-                    rot->rotBtn.currentState = SWITCH_PRESSED;
+                    RotaryEncoder_PostButtonEvent( SWITCH_PRESSED, currentTimestamp );
 
                 }
 
-                rot->rotBtn.hasSwitchBeenPressed = true;
                 rot->rotBtn.lastFallingEdgeTimestamp_cts = currentTimestamp;
                 break;
             default:
@@ -203,4 +326,32 @@ static void RotaryEncoder_ReadButtonISR( void )
         }
     }
     return;
+}
+
+/*
+ * Function:         
+ *      RotaryEncoder_PostButtonEvent
+ *
+ * Description: 
+ *      ISR side of the button event queue. Writes the event into the slot at eventHead, then advances
+ *      eventHead to publish it. Counts the event as an overflow instead if the queue is full.
+ * 
+ */
+static void RotaryEncoder_PostButtonEvent( const RotarySwitchState state,
+                                           const uint32_t timestamp_cts )
+{
+    uint8_t head = rot->rotBtn.eventHead;
+    if( (uint8_t) ( head - rot->rotBtn.eventTail ) >= ROT_BTN_EVENT_QUEUE_SIZE )
+    {
+        if( rot->rotBtn.eventOverflowCount < 0xFFu )
+        {
+            rot->rotBtn.eventOverflowCount++;
+        }
+        return;
+    }
+
+    rot->rotBtn.events[head & ROT_BTN_EVENT_QUEUE_MASK].state = state;
+    rot->rotBtn.events[head & ROT_BTN_EVENT_QUEUE_MASK].timestamp_cts = timestamp_cts;
+    rot->rotBtn.eventHead = head + 1u;
+    return;
 }
\ No newline at end of file
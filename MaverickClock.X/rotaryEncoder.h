@@ -17,6 +17,17 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+/******************* Macro Definition(s) *******/
+/* Counts reported per detent: 1 counts on arrival at the resting state (both pins low), 2 also counts
+ * at the opposite state, 4 counts every quadrature transition. */
+#ifndef ROT_ENC_COUNTS_PER_DETENT
+#define ROT_ENC_COUNTS_PER_DETENT 1
+#endif
+
+#if ( ROT_ENC_COUNTS_PER_DETENT != 1 ) && ( ROT_ENC_COUNTS_PER_DETENT != 2 ) && ( ROT_ENC_COUNTS_PER_DETENT != 4 )
+#error "ROT_ENC_COUNTS_PER_DETENT must be 1, 2, or 4"
+#endif
+
 /******************* Type definition(s) ********/
 
 typedef enum
@@ -33,19 +44,36 @@ typedef enum
     ROT_ENC_CCW_DIR
 } ROTARY_ENCODER_DIRECTION;
 
+/* Number of button events the ISR can queue ahead of the main loop. Must be a power of two that
+ * divides 256, so the free running 8 bit indices wrap cleanly. */
+#define ROT_BTN_EVENT_QUEUE_SIZE 8u
+#define ROT_BTN_EVENT_QUEUE_MASK ( ROT_BTN_EVENT_QUEUE_SIZE - 1u )
+
+/* A classified button release and the TMR3 timestamp it happened at */
+typedef struct
+{
+    RotarySwitchState state;
+    uint32_t timestamp_cts;
+} RotaryButtonEvent;
+
 /* Configuration and data structures for the rotary push button. 
  *
- * 
- * 
+ * events is a single producer, single consumer ring. The ISR writes an event and then advances
+ * eventHead. The main loop reads an event and then advances eventTail. Each index is one byte and
+ * written by one side only, so neither side masks interrupts. Events that arrive while the ring is
+ * full are counted in eventOverflowCount.
  */
 typedef struct
 {
-    volatile RotarySwitchState currentState;
-    volatile uint16_t lastRisingEdgeTimestamp_cts;
-    volatile uint16_t lastFallingEdgeTimestamp_cts;
-    volatile bool hasSwitchBeenPressed;
+    volatile uint32_t lastRisingEdgeTimestamp_cts;
+    volatile uint32_t lastFallingEdgeTimestamp_cts;
     volatile size_t currentNumMulticlicks;
 
+    RotaryButtonEvent events[ROT_BTN_EVENT_QUEUE_SIZE];
+    volatile uint8_t eventHead;
+    volatile uint8_t eventTail;
+    volatile uint8_t eventOverflowCount; // Saturates at 255
+
     struct
     {
         const uint16_t multiClickTimerThreshold_cts; // Number of timer counts required for a double click to be registered 
@@ -57,23 +85,33 @@ typedef struct
 /* Configuration and data structures for rotary shaft encoder. 
  * 
  * uint8_t vector - written during interrupt. Saves the last read and the current read
- * int32_t counts - updated based on rotary turn direction. Polled and reset during mainloop
+ * int8_t quarterSteps - ISR only. Sum of the decoded transitions since the last reported count
+ * uint8_t invalidTransitionCount - transitions where both pins changed at once, a sign of noise. Saturates at 255
+ * uint16_t counts - free running, incremented or decremented by the ISR per detent step. Never written by the mainloop.
+ *      16 bits, so a fast spin at the largest acceleration step cannot wrap it between polls
+ * uint16_t lastSeenCounts - mainloop only. The value of counts at the last poll, the difference is the new counts
  * currentDirection - saves the encoders current direction
+ * currentTimestamp_tr - Extended TMR3 timestamp of the last detent
+ * detentInterval_cts - TMR3 counts between the last two detents. Short intervals mean a fast spin, and
+ *      select a larger step from the acceleration curve in rotaryEncoder.c
  * 
  * 
  */
 typedef struct
 {
     volatile uint8_t vector;
-    volatile int32_t counts;
+    int8_t quarterSteps;
+    volatile uint8_t invalidTransitionCount;
+    volatile uint16_t counts;
+    uint16_t lastSeenCounts;
     ROTARY_ENCODER_DIRECTION currentDirection;
 
-    uint16_t currentTimestamp_tr; // tr: Comes from timer register
-    uint16_t velocity_tps; // current velocity in turns per second. 
+    uint32_t currentTimestamp_tr; // tr: Comes from timer register, extended to 32 bits
+    uint16_t detentInterval_cts;
 
     struct
     {
-        const uint16_t velocityTolerance_tps;
+        const bool isAccelerationEnabled; // False counts every detent as 1
     } config;
 
 } ShaftEncoder;
@@ -97,10 +135,21 @@ typedef struct
 bool RotaryEncoder_Init(RotaryEncoder * const rotEncPtr);
 
 
-/* Sets relevant rotary encoder parameters to zero, starts timer 3, and enables external int. */
+/* Function:
+ *      RotaryEncoder_SetEventHandler
+ *
+ * Description:
+ *      Registers a function for the shaft and button ISRs to call on every edge, enabled or not, such as
+ *      one that wakes the main loop. Runs in interrupt context. NULL removes it.
+ */
+void RotaryEncoder_SetEventHandler(void (* eventHandler)(void));
+
+
+/* Sets relevant rotary encoder parameters to zero and lets the pin change ISRs count again. */
 void RotaryEncoder_Enable(void);
 
-/* Disable external interrupts, sets enabled to false, and stops timer3. */
+/* Sets enabled to false, so the pin change ISRs ignore the encoder. Timer 3 keeps running: it is the
+ * free running system timebase that pattern frame deadlines are scheduled from, not an encoder timer. */
 void RotaryEncoder_Disable(void);
 
 
@@ -108,32 +157,68 @@ void RotaryEncoder_Disable(void);
  *      RotaryEncoder_GetCounts
  * 
  * Description: 
- *      Function to poll when the current shaft counts are wanted.  Returns the current shaft count value and resets the counts value to zero. 
+ *      Function to poll when the current shaft counts are wanted. Returns the counts turned since the last call,
+ *      scaled by the acceleration curve. The ISR's counter is a free running 16 bit value that only the ISR
+ *      writes. It is read until two reads agree, so a read torn by the ISR is never used, and the difference
+ *      from the last seen value is exact without masking interrupts, as long as fewer than 32768 counts pass
+ *      between polls.
  * 
  * Return: 
- *      Rotary encoder shaft count value
+ *      Signed number of detents since the last call, clockwise positive
  */
 int32_t RotaryEncoder_GetShaftCounts(void);
 
 /* Function: 
- *      RotaryEncoder_GetSwitchState
+ *      RotaryEncoder_GetInvalidTransitionCount
  * 
  * Description: 
- *      Returns the most recent switch state. Only checks for an update if the  hasBeenPressed flag is set. Otherwise, 
- *      returns the latest valid state. 
+ *      Returns the number of shaft interrupts where both pins had changed. Noise diagnostics only.
  */
-RotarySwitchState RotaryEncoder_GetSwitchState(void);
+uint8_t RotaryEncoder_GetInvalidTransitionCount(void);
+
+
+/* Function: 
+ *      RotaryEncoder_GetButtonEvent
+ * 
+ * Description: 
+ *      Removes the oldest queued button event and copies it to event. Events are returned in the order
+ *      they happened, so a press followed by a double click is seen as both.
+ *
+ * Return:
+ *      True if an event was copied, false if the queue is empty.
+ */
+bool RotaryEncoder_GetButtonEvent(RotaryButtonEvent * const event);
 
 
 /* Function:
  *      RotaryEncoder_HasButtonPressOccurred
  * 
  * Description: 
- *      Returns a button pressed flag to the external caller. Acts as a "service" flag.  Resets the HasButtonPressOccurred back to false. 
- * 
+ *      Removes the oldest queued button event, whatever its type. Used where any press will do.
+ *
+ * Return:
+ *      True if an event was removed.
  */
 bool RotaryEncoder_HasButtonPressOccurred(void);
 
 
+/* Function:
+ *      RotaryEncoder_FlushButtonEvents
+ * 
+ * Description: 
+ *      Discards every queued button event.
+ */
+void RotaryEncoder_FlushButtonEvents(void);
+
+
+/* Function:
+ *      RotaryEncoder_GetButtonEventOverflowCount
+ * 
+ * Description: 
+ *      Returns the number of button events dropped because the queue was full. Saturates at 255.
+ */
+uint8_t RotaryEncoder_GetButtonEventOverflowCount(void);
+
+
 
 #endif
\ No newline at end of file
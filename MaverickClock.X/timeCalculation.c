@@ -16,41 +16,176 @@
 /*********************** Included File(s) ********************************/
 #include "timeCalculation.h"
 #include "mcc_generated_files/tmr5.h"
+#include "mcc_generated_files/memory.h"
+#include "CRC16bit.h"
 #include "rotaryEncoder.h"
 #include "clockLEDs.h"
 #include <stdlib.h>
 #include <xc.h>
 
-/*********************** Local Variable(s) *******************************/
-static volatile uint32_t currentTimeInSeconds = 0u; // Shared data between polled routines and ISR incrementer. 
+/*********************** Type Definition(s) ******************************/
+/* Packed BCD time, tens digit in the high nibble. Hours run 0x01 to 0x12. */
+typedef struct
+{
+    uint8_t hours;
+    uint8_t minutes;
+    uint8_t seconds;
+} BcdTime;
+
 
+/*********************** Local Variable(s) *******************************/
+/* Written only by the tick ISR. The main loop never masks the tick, it reads with a sequence
+ * check instead: the ISR bumps timeSequence every time it runs, so a copy taken between two equal
+ * reads of timeSequence cannot be torn. */
+static volatile BcdTime currentTime = {0x01u, 0x00u, 0x00u};
+static volatile uint8_t timeSequence = 0u;
+static volatile bool hasMinuteRolled = true; // Set by the ISR on every minute change. Starts true to force the first render.
 
+/* Encoder edits are handed to the ISR instead of written by the main loop. The main loop writes
+ * pendingAdjustmentMinutes only while isAdjustmentPending is false, then sets it. The ISR applies the
+ * adjustment on its next tick and clears the flag. Both are single byte handshakes. */
+static volatile int16_t pendingAdjustmentMinutes = 0;
+static volatile bool isAdjustmentPending = false;
+static int16_t queuedAdjustmentMinutes = 0; // Main loop only. Edits made while the ISR still owns the last handoff.
 
-/************************ Function Macro Definition(s) *******************/
-// limit: IF value is less than low, make value high. Else if value is greater than high, make low. Else, nothing.
-#define limit(val, low, high) ( (val < low) ? high : (val > high) ? low : val)
+static volatile int16_t trimPpm = 0; // Read by the ISR every second
+static int32_t trimAccumulatorPpm = 0; // ISR only. Fraction of a second gained or lost, in ppm.
+static volatile uint16_t lostTickCount = 0u; // Seconds credited by the missed period catch up. Instrumentation, wraps.
+static void (*Time_TickEventHandler)( void ) = NULL; // Called by the tick ISR every second
 
 
 /*********************** Macro Definition (s) ****************************/
 #define MAX_NUM_SECONDS 43199u
+#define MAX_MINUTE_INDEX 719 // 12:59, minutes since 1:00
 #define SECONDS_OFFSET 3600u
 #define NUM_SECONDS_IN_MINUTE 60u
 #define NUM_MINUTES_IN_HOURS 60u
 #define NUM_COUNTS_PER_SECOND 60 // corresponds to seconds, just added another macro here for readability
+#define NUM_SECONDS_IN_HOUR 3600u
+
+#define BCD_MAX_SECONDS 0x59u
+#define BCD_MAX_MINUTES 0x59u
+#define BCD_MAX_HOURS 0x12u
+#define BCD_FIRST_HOUR 0x01u
+#define BCD_ONES_MASK 0x0Fu
+#define BCD_TENS_SHIFT 4u
+#define BCD_ONES_ROLLOVER 0x09u
+#define BCD_TENS_INCREMENT 0x10u
+
+#define PPM_PER_SECOND 1000000l
+#define TRIM_RETRIES 3u
+
+/* SOSC: 32768 Hz, 1:1 prescale, so 32768 counts per second. Asynchronous, since the crystal is
+ * unrelated to the system clock.
+ * T5CON: TMR5CS SOSC/T5CKI; T5CKPS 1:1; T5SOSC enabled; T5SYNC do not synchronize; TMR5ON off until
+ * Time_EnableTimeModule */
+#define SOSC_T5CON 0x8Cu
+#define SOSC_RELOAD_VALUE 0x8000u
+
 
 
 /*********************** Function Prototype(s) ***************************/
 static void Time_IncrementSecondsISR( void );
+static inline bool Time_IncrementBcd( volatile uint8_t * const bcdValue,
+                                      const uint8_t bcdMax );
+static inline uint8_t Time_BcdToBinary( const uint8_t bcdValue );
+static inline uint8_t Time_BinaryToBcd( const uint8_t binaryValue );
+static uint32_t Time_BcdTimeToSeconds( const BcdTime * const t );
+static uint16_t Time_BcdTimeToMinuteIndex( const BcdTime * const t );
+static void Time_ApplyMinutesAdjustment( BcdTime * const t,
+                                         const int16_t minutesDelta );
+static void Time_QueueMinutesAdjustment( const int32_t minutesDelta );
+static void Time_ReadSnapshot( BcdTime * const t );
+static void Time_RenderBcdTime( const BcdTime * const t );
+static void Time_AdvanceOneSecond( void );
 
 /************************** Functions ************************************/
 
 
 void Time_InitializeTimeModule( void )
 {
+#if ( TIME_USE_SOSC == 1 )
+    TMR5_StopTimer( );
+    T5CON = SOSC_T5CON;
+    timer5ReloadVal = SOSC_RELOAD_VALUE;
+    TMR5_WriteTimer( timer5ReloadVal );
+#endif
+
+    uint8_t trimBlock[NUM_BYTES_EEPROM_TRIM_BLOCK];
+    trimBlock[0] = DATAEE_ReadByte( EEPROM_ADDR_TRIM_HB );
+    trimBlock[1] = DATAEE_ReadByte( EEPROM_ADDR_TRIM_LB );
+    trimBlock[2] = DATAEE_ReadByte( EEPROM_ADDR_TRIM_CRC_HB );
+    trimBlock[3] = DATAEE_ReadByte( EEPROM_ADDR_TRIM_CRC_LB );
+    if( CRC16_Calculate16bitCRC( trimBlock, NUM_BYTES_EEPROM_TRIM_BLOCK, 0xFFFF ) == 0u )
+    {
+        trimPpm = (int16_t) ( ( (uint16_t) trimBlock[0] << 8u ) | trimBlock[1] );
+    }
+
     TMR5_SetInterruptHandler( Time_IncrementSecondsISR );
     return;
 }
 
+bool Time_SetTrimPpm( const int16_t newTrimPpm )
+{
+    uint8_t trimBytes[2] = {
+        (uint8_t) ( ( (uint16_t) newTrimPpm & 0xFF00u ) >> 8u ),
+        (uint8_t) ( (uint16_t) newTrimPpm & 0xFFu )
+    };
+    uint16_t crc = CRC16_Calculate16bitCRC( trimBytes, sizeof (trimBytes ), 0xFFFF );
+
+    /* Two byte value read by the ISR. A rare configuration write, so the tick is simply held off. */
+    uint8_t wasTickEnabled = PIE4bits.TMR5IE;
+    PIE4bits.TMR5IE = 0;
+    trimPpm = newTrimPpm;
+    PIE4bits.TMR5IE = wasTickEnabled;
+
+    size_t maxRetries = TRIM_RETRIES;
+    uint8_t trimBlock[NUM_BYTES_EEPROM_TRIM_BLOCK];
+    while( maxRetries )
+    {
+        DATAEE_WriteByte( EEPROM_ADDR_TRIM_HB, trimBytes[0] );
+        DATAEE_WriteByte( EEPROM_ADDR_TRIM_LB, trimBytes[1] );
+        DATAEE_WriteByte( EEPROM_ADDR_TRIM_CRC_HB, (uint8_t) ( ( crc & 0xFF00u ) >> 8u ) );
+        DATAEE_WriteByte( EEPROM_ADDR_TRIM_CRC_LB, (uint8_t) ( crc & 0xFFu ) );
+
+        trimBlock[0] = DATAEE_ReadByte( EEPROM_ADDR_TRIM_HB );
+        trimBlock[1] = DATAEE_ReadByte( EEPROM_ADDR_TRIM_LB );
+        trimBlock[2] = DATAEE_ReadByte( EEPROM_ADDR_TRIM_CRC_HB );
+        trimBlock[3] = DATAEE_ReadByte( EEPROM_ADDR_TRIM_CRC_LB );
+        if( CRC16_Calculate16bitCRC( trimBlock, NUM_BYTES_EEPROM_TRIM_BLOCK, 0xFFFF ) == 0u )
+        {
+            return true;
+        }
+        maxRetries--;
+    }
+    return false;
+}
+
+int16_t Time_GetTrimPpm( void )
+{
+    uint8_t wasTickEnabled = PIE4bits.TMR5IE;
+    PIE4bits.TMR5IE = 0;
+    int16_t thisTrimPpm = trimPpm;
+    PIE4bits.TMR5IE = wasTickEnabled;
+    return thisTrimPpm;
+}
+
+uint16_t Time_GetLostTickCount( void )
+{
+    /* Two byte value written by the ISR, so the tick is held off for the read */
+    uint8_t wasTickEnabled = PIE4bits.TMR5IE;
+    PIE4bits.TMR5IE = 0;
+    uint16_t thisLostTickCount = lostTickCount;
+    PIE4bits.TMR5IE = wasTickEnabled;
+    return thisLostTickCount;
+}
+
+void Time_SetTickEventHandler( void (* tickHandler)( void ) )
+{
+    Time_TickEventHandler = tickHandler;
+    return;
+}
+
 void Time_EnableTimeModule( void )
 {
     TMR5_StartTimer( );
@@ -65,83 +200,336 @@ void Time_DisableTimeModule( void )
 
 void Time_RenderIfMinutesHaveChanged( bool isSwitchPressHrMnMode )
 {
-    /* Save the minutes at last change value. This is only updated when a time change in minutes has been detected */
-    static uint16_t minutesAtLastChange = 0xFFFF; // Make this 0xFF at first so that at startup, it's forced to change. 
-
     /* Get rotary encoder counts and change time accordingly */
     int32_t minutesDelta = RotaryEncoder_GetShaftCounts( );
 
-    if( isSwitchPressHrMnMode )
+    if( 0 != minutesDelta )
     {
-        minutesDelta *= 60u;
+        if( isSwitchPressHrMnMode )
+        {
+            minutesDelta *= 60u;
+        }
+        Time_QueueMinutesAdjustment( minutesDelta );
     }
-
-    int32_t thisTimeInSeconds = (int32_t) currentTimeInSeconds + ( minutesDelta * NUM_COUNTS_PER_SECOND );
-    thisTimeInSeconds = limit( thisTimeInSeconds, 0, MAX_NUM_SECONDS );
-    currentTimeInSeconds = ( volatile uint32_t ) thisTimeInSeconds; // Reset the volatile timer variable back
-    uint16_t currentTimeInMinutes = (uint16_t) ( currentTimeInSeconds / NUM_SECONDS_IN_MINUTE );
-
-    /* If a minutes change has occurred, update the minutes at last change and render the current minutes*/
-    if( currentTimeInMinutes != minutesAtLastChange )
+    else if( 0 != queuedAdjustmentMinutes )
     {
-        minutesAtLastChange = currentTimeInMinutes;
-        uint8_t hours = (uint8_t) ( currentTimeInMinutes / NUM_MINUTES_IN_HOURS ) + 1u;
-        uint8_t minutes = (uint8_t) ( currentTimeInMinutes % NUM_MINUTES_IN_HOURS );
-
-        TimeInDigits t = {
-            .digit1 = ( hours % 100 ) / 10,
-            .digit2 = ( hours % 10 ),
-            .digit3 = ( minutes % 100 ) / 10,
-            .digit4 = ( minutes % 10 )
-        };
+        Time_QueueMinutesAdjustment( 0 ); // Edits queued while the ISR held the last handoff
+    }
 
-        Clock_WriteTimeDigitValuesAndRenderScreen( &t );
+    /* Nothing to render until the ISR or the encoder changes the minutes. Clear the flag before
+     * the snapshot, so a minute that rolls in between is still in the snapshot. */
+    if( ( !hasMinuteRolled ) &&
+        ( 0 == minutesDelta ) )
+    {
+        return;
     }
+    hasMinuteRolled = false;
+
+    BcdTime snapshot;
+    Time_ReadSnapshot( &snapshot );
+    Time_RenderBcdTime( &snapshot );
     return;
 }
 
 uint32_t Time_GetCurrentTimeInSeconds( void)
 {
-    return currentTimeInSeconds;
+    BcdTime snapshot;
+    Time_ReadSnapshot( &snapshot );
+    return Time_BcdTimeToSeconds( &snapshot );
 }
 
 void Time_RenderInputTime( uint32_t timeInSeconds,
                            bool setCurrentTime )
 {
     uint16_t currentTimeInMinutes = (uint16_t) ( timeInSeconds / NUM_SECONDS_IN_MINUTE );
+    BcdTime t = {
+        .hours = Time_BinaryToBcd( (uint8_t) ( currentTimeInMinutes / NUM_MINUTES_IN_HOURS ) + 1u ),
+        .minutes = Time_BinaryToBcd( (uint8_t) ( currentTimeInMinutes % NUM_MINUTES_IN_HOURS ) ),
+        .seconds = 0u
+    };
+
+    /* Setting the time is an adjustment by the difference in minutes, so it goes through the same
+     * handoff as an encoder edit. The running seconds are kept. */
+    if( setCurrentTime )
+    {
+        BcdTime snapshot;
+        Time_ReadSnapshot( &snapshot );
+        Time_QueueMinutesAdjustment( (int32_t) currentTimeInMinutes - (int32_t) Time_BcdTimeToMinuteIndex( &snapshot ) );
+    }
 
-    /* If a minutes change has occurred, update the minutes at last change and render the current minutes*/
+    Time_RenderBcdTime( &t );
+    return;
+}
 
-    uint8_t hours = (uint8_t) ( currentTimeInMinutes / NUM_MINUTES_IN_HOURS ) + 1u;
-    uint8_t minutes = (uint8_t) ( currentTimeInMinutes % NUM_MINUTES_IN_HOURS );
+/* Function:
+ *      Time_ReadSnapshot
+ *
+ * Description:
+ *      Copies the current time without masking the tick interrupt, retrying if the ISR ran during
+ *      the copy. Adjustments the ISR hasn't applied yet are applied to the copy, so the display
+ *      follows the encoder immediately rather than on the next tick.
+ */
+static void Time_ReadSnapshot( BcdTime * const t )
+{
+    uint8_t sequence;
+    bool isHandoffPending;
+    do
+    {
+        sequence = timeSequence;
+        t->hours = currentTime.hours;
+        t->minutes = currentTime.minutes;
+        t->seconds = currentTime.seconds;
+        isHandoffPending = isAdjustmentPending;
+    } while( sequence != timeSequence );
 
-    TimeInDigits t = {
-        .digit1 = ( hours % 100 ) / 10,
-        .digit2 = ( hours % 10 ),
-        .digit3 = ( minutes % 100 ) / 10,
-        .digit4 = ( minutes % 10 )
-    };
+    if( isHandoffPending )
+    {
+        Time_ApplyMinutesAdjustment( t, pendingAdjustmentMinutes );
+    }
+    Time_ApplyMinutesAdjustment( t, queuedAdjustmentMinutes );
+    return;
+}
 
-    if( setCurrentTime )
+/* Function:
+ *      Time_QueueMinutesAdjustment
+ *
+ * Description:
+ *      Adds an edit to the main loop's queue and hands the queue to the ISR if the ISR has consumed
+ *      the previous handoff. The queue is clamped to one full wrap, which is all limit semantics can
+ *      distinguish.
+ */
+static void Time_QueueMinutesAdjustment( const int32_t minutesDelta )
+{
+    int32_t queued = (int32_t) queuedAdjustmentMinutes + minutesDelta;
+    if( queued > MAX_MINUTE_INDEX + 1 )
+    {
+        queued = MAX_MINUTE_INDEX + 1;
+    }
+    else if( queued < -( MAX_MINUTE_INDEX + 1 ) )
     {
-        currentTimeInSeconds = timeInSeconds;
+        queued = -( MAX_MINUTE_INDEX + 1 );
     }
+    queuedAdjustmentMinutes = (int16_t) queued;
 
-    Clock_WriteTimeDigitValuesAndRenderScreen( &t );
+    if( ( !isAdjustmentPending ) &&
+        ( 0 != queuedAdjustmentMinutes ) )
+    {
+        pendingAdjustmentMinutes = queuedAdjustmentMinutes;
+        isAdjustmentPending = true; // Publishes pendingAdjustmentMinutes to the ISR
+        queuedAdjustmentMinutes = 0;
+    }
     return;
 }
 
+/* Function:
+ *      Time_ApplyMinutesAdjustment
+ *
+ * Description:
+ *      Moves a BCD time by a number of minutes. Past 12:59 the time becomes 1:00:00 and before 1:00
+ *      it becomes 12:59:59, the same limit behavior the seconds counter used to have.
+ */
+static void Time_ApplyMinutesAdjustment( BcdTime * const t,
+                                         const int16_t minutesDelta )
+{
+    if( 0 == minutesDelta )
+    {
+        return;
+    }
+
+    int16_t minuteIndex = (int16_t) Time_BcdTimeToMinuteIndex( t ) + minutesDelta;
+    if( minuteIndex < 0 )
+    {
+        minuteIndex = MAX_MINUTE_INDEX;
+        t->seconds = BCD_MAX_SECONDS;
+    }
+    else if( minuteIndex > MAX_MINUTE_INDEX )
+    {
+        minuteIndex = 0;
+        t->seconds = 0u;
+    }
+
+    t->hours = Time_BinaryToBcd( (uint8_t) ( (uint16_t) minuteIndex / NUM_MINUTES_IN_HOURS ) + 1u );
+    t->minutes = Time_BinaryToBcd( (uint8_t) ( (uint16_t) minuteIndex % NUM_MINUTES_IN_HOURS ) );
+    return;
+}
+
+/* Function:
+ *      Time_BcdTimeToMinuteIndex
+ *
+ * Description:
+ *      Converts a BCD time to minutes since 1:00, the range 0 to MAX_MINUTE_INDEX.
+ */
+static uint16_t Time_BcdTimeToMinuteIndex( const BcdTime * const t )
+{
+    return ( (uint16_t) ( Time_BcdToBinary( t->hours ) - 1u ) * NUM_MINUTES_IN_HOURS ) +
+        Time_BcdToBinary( t->minutes );
+}
+
+/* Function:
+ *      Time_RenderBcdTime
+ *
+ * Description:
+ *      Splits packed BCD hours and minutes into display digits. Nibble operations only, no division.
+ */
+static void Time_RenderBcdTime( const BcdTime * const t )
+{
+    TimeInDigits digits = {
+        .digit1 = t->hours >> BCD_TENS_SHIFT,
+        .digit2 = t->hours & BCD_ONES_MASK,
+        .digit3 = t->minutes >> BCD_TENS_SHIFT,
+        .digit4 = t->minutes & BCD_ONES_MASK
+    };
+
+    Clock_WriteTimeDigitValuesAndRenderScreen( &digits );
+    return;
+}
+
+/* Function:
+ *      Time_BcdTimeToSeconds
+ *
+ * Description:
+ *      Converts a BCD time to seconds since 1:00:00, the range 0 to MAX_NUM_SECONDS.
+ */
+static uint32_t Time_BcdTimeToSeconds( const BcdTime * const t )
+{
+    return ( (uint32_t) ( Time_BcdToBinary( t->hours ) - 1u ) * NUM_SECONDS_IN_HOUR ) +
+        ( (uint32_t) Time_BcdToBinary( t->minutes ) * NUM_SECONDS_IN_MINUTE ) +
+        Time_BcdToBinary( t->seconds );
+}
+
+/* Function:
+ *      Time_BcdToBinary
+ *
+ * Description:
+ *      Converts a two digit packed BCD value to binary.
+ */
+static inline uint8_t Time_BcdToBinary( const uint8_t bcdValue )
+{
+    return (uint8_t) ( ( bcdValue >> BCD_TENS_SHIFT ) * 10u ) + ( bcdValue & BCD_ONES_MASK );
+}
+
+/* Function:
+ *      Time_BinaryToBcd
+ *
+ * Description:
+ *      Converts a binary value below 100 to two digit packed BCD.
+ */
+static inline uint8_t Time_BinaryToBcd( const uint8_t binaryValue )
+{
+    return (uint8_t) ( ( binaryValue / 10u ) << BCD_TENS_SHIFT ) | ( binaryValue % 10u );
+}
+
 /* Function:
  *      void Time_IncrementSecondsISR(void)
  *
  * Description:
- *      ISR to increment the seconds value. Handles rollover. Called once every second. 
+ *      ISR to increment the BCD time. Applies any adjustment handed off by the main loop first.
+ *      Advances one second plus any periods TMR5_ISR found missed. Accumulates the ppm trim per
+ *      elapsed second, adding or dropping a second whenever the trim adds up to a whole one.
+ *      Called once every second.
  */
 static void Time_IncrementSecondsISR( void )
 {
-    currentTimeInSeconds = ( currentTimeInSeconds + 1 > MAX_NUM_SECONDS ) ? 0 : currentTimeInSeconds + 1;
+    if( Time_TickEventHandler )
+    {
+        Time_TickEventHandler( );
+    }
+    timeSequence++; // Any main loop snapshot in progress will retry
+
+    if( isAdjustmentPending )
+    {
+        BcdTime adjustedTime = {currentTime.hours, currentTime.minutes, currentTime.seconds};
+        Time_ApplyMinutesAdjustment( &adjustedTime, pendingAdjustmentMinutes );
+        currentTime.hours = adjustedTime.hours;
+        currentTime.minutes = adjustedTime.minutes;
+        currentTime.seconds = adjustedTime.seconds;
+        isAdjustmentPending = false; // Hands pendingAdjustmentMinutes back to the main loop
+        hasMinuteRolled = true;
+    }
+
+    /* Credit the seconds whose overflow was missed while interrupts were masked */
+    uint8_t missedSeconds = TMR5_TakeMissedPeriods( );
+    uint16_t elapsedSeconds = 1u + missedSeconds;
+    lostTickCount += missedSeconds;
+
+    while( elapsedSeconds )
+    {
+        elapsedSeconds--;
+        trimAccumulatorPpm += trimPpm;
+        if( trimAccumulatorPpm >= PPM_PER_SECOND )
+        {
+            trimAccumulatorPpm -= PPM_PER_SECOND;
+            Time_AdvanceOneSecond( ); // Running slow, catch up a second
+        }
+        else if( trimAccumulatorPpm <= -PPM_PER_SECOND )
+        {
+            trimAccumulatorPpm += PPM_PER_SECOND;
+            continue; // Running fast, drop this second
+        }
+        Time_AdvanceOneSecond( );
+    }
+    return;
+}
+
+/* Function:
+ *      Time_AdvanceOneSecond
+ *
+ * Description:
+ *      Increments the BCD time by one second. Handles rollover from 12:59:59 to 1:00:00 and flags
+ *      every minute change for the main loop. ISR only.
+ */
+static void Time_AdvanceOneSecond( void )
+{
+    if( !Time_IncrementBcd( &currentTime.seconds, BCD_MAX_SECONDS ) )
+    {
+        return;
+    }
+
+    hasMinuteRolled = true;
+    if( !Time_IncrementBcd( &currentTime.minutes, BCD_MAX_MINUTES ) )
+    {
+        return;
+    }
+
+    if( BCD_MAX_HOURS == currentTime.hours )
+    {
+        currentTime.hours = BCD_FIRST_HOUR;
+    }
+    else
+    {
+        (void) Time_IncrementBcd( &currentTime.hours, BCD_MAX_HOURS );
+    }
     return;
 }
 
+/* Function:
+ *      Time_IncrementBcd
+ *
+ * Description:
+ *      Increments a two digit packed BCD value, wrapping to zero past bcdMax.
+ *
+ * Return:
+ *      True if the value wrapped.
+ */
+static inline bool Time_IncrementBcd( volatile uint8_t * const bcdValue,
+                                      const uint8_t bcdMax )
+{
+    if( *bcdValue >= bcdMax )
+    {
+        *bcdValue = 0u;
+        return true;
+    }
+
+    if( BCD_ONES_ROLLOVER == ( *bcdValue & BCD_ONES_MASK ) )
+    {
+        *bcdValue = ( *bcdValue & (uint8_t) ~BCD_ONES_MASK ) + BCD_TENS_INCREMENT;
+    }
+    else
+    {
+        ( *bcdValue )++;
+    }
+    return false;
+}
+
 
 /* End timeCalculation.c source file */
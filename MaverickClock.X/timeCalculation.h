@@ -12,19 +12,85 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/************************ Macro Definition(s) *****************/
+/* Set to 1 when a 32.768 kHz crystal is fitted on SOSCI/SOSCO. TMR5 then counts the crystal
+ * instead of LFINTOSC, which is only accurate to a few percent. */
+#ifndef TIME_USE_SOSC
+#define TIME_USE_SOSC 0
+#endif
+
+/* Trim block, follows the color block in changeColorMode.h. Signed ppm, high byte first, then the
+ * CRC of the trim bytes. */
+#define EEPROM_ADDR_TRIM_HB 0x7008u
+#define EEPROM_ADDR_TRIM_LB 0x7009u
+#define EEPROM_ADDR_TRIM_CRC_HB 0x700Au
+#define EEPROM_ADDR_TRIM_CRC_LB 0x700Bu
+
+#define NUM_BYTES_EEPROM_TRIM_BLOCK 4u
+
 /************************ Function Prototype(s) ***************/
 
 /* Function:
  *      Time_InitializeTimeModule
  *
  * Description:
- *      Links the timer interrupt to the Timer 5 callback register.
+ *      Links the timer interrupt to the Timer 5 callback register. Switches TMR5 to the crystal
+ *      if TIME_USE_SOSC is set, and loads the trim saved in EEPROM (0 if the block is invalid).
  *
  */
 void Time_InitializeTimeModule(void);
 
 
 
+/* Function:
+ *      Time_SetTrimPpm
+ *
+ * Description:
+ *      Sets the timebase trim in parts per million and saves it to EEPROM. Positive values speed
+ *      the clock up: a clock losing 20 s per day (231 ppm slow) needs a trim of +231. The ISR
+ *      accumulates the trim every second and inserts or drops a whole second each time it adds up to
+ *      one million.
+ *
+ * Return:
+ *      True if the EEPROM readback matched.
+ */
+bool Time_SetTrimPpm(const int16_t trimPpm);
+
+
+
+/* Function:
+ *      Time_GetTrimPpm
+ *
+ * Description:
+ *      Returns the active timebase trim in parts per million.
+ */
+int16_t Time_GetTrimPpm(void);
+
+
+
+/* Function:
+ *      Time_GetLostTickCount
+ *
+ * Description:
+ *      Returns the number of seconds whose timer overflow was never serviced because interrupts
+ *      were masked for longer than a second. Each one has been credited to the time, the count is
+ *      instrumentation only. Wraps at 65535.
+ */
+uint16_t Time_GetLostTickCount(void);
+
+
+
+/* Function:
+ *      Time_SetTickEventHandler
+ *
+ * Description:
+ *      Registers a function for the tick ISR to call once a second, such as one that wakes the main
+ *      loop. Runs in interrupt context. NULL removes it.
+ */
+void Time_SetTickEventHandler(void (* tickHandler)(void));
+
+
+
 /* Function:
  *      Time_EnableTimeModule
  *
@@ -50,7 +116,8 @@ void Time_DisableTimeModule(void);
  *
  * Description:
  *      Function periodically polled in the mainloop to determine if
- *      a time update (in minutes) has occurred.
+ *      a time update (in minutes) has occurred. The tick ISR keeps the time in BCD and flags
+ *      every minute change, so an idle call only reads the encoder and tests that flag.
  */
 void Time_RenderIfMinutesHaveChanged(bool isSwitchPressHrMnMode);
 
@@ -19,30 +19,376 @@
 
 
 /****************** Macro Definition(s) *******************/
-#define WRITE_ONE()      DATA_PIN_SetHigh(); NOP(); NOP(); NOP(); NOP(); DATA_PIN_SetLow(); NOP(); NOP();
-#define WRITE_ZERO()     DATA_PIN_SetHigh(); NOP(); DATA_PIN_SetLow(); NOP(); NOP(); NOP(); NOP(); NOP();
+#define NS_PER_INSTRUCTION_CYCLE ( 4000000000ul / _XTAL_FREQ ) // 4 clocks per instruction, 125 ns at 32 MHz
 
-#define NUM_BITS_IN_RGB_PIXEL 24u
-#define GREEN_LEFT_SHIFT_OFFSET 16u
-#define RED_LEFT_SHIFT_OFFSET 8u
-#define NUM_BITS_IN_BYTE 8u
+/* Datasheet timing, see ws2812b.h */
+#define WS2812B_ONE_HIGH_NS 800u
+#define WS2812B_ONE_LOW_NS 450u
+#define WS2812B_ZERO_HIGH_NS 400u
+#define WS2812B_ZERO_LOW_NS 850u
+#define WS2812B_TOLERANCE_NS 150u
+#define WS2812B_MAX_LOW_NS 5000u // Low times longer than this risk being treated as a latch.
+
+#define CYCLES_TO_NS(cycles) ( (unsigned long) ( cycles ) * NS_PER_INSTRUCTION_CYCLE )
+#define IS_NS_WITHIN_TOLERANCE(ns, nominal) \
+    ( ( ( ns ) >= ( nominal ) - WS2812B_TOLERANCE_NS ) && \
+      ( ( ns ) <= ( nominal ) + WS2812B_TOLERANCE_NS ) )
+#define IS_WITHIN_TOLERANCE(cycles, nominal) IS_NS_WITHIN_TOLERANCE( CYCLES_TO_NS( cycles ), nominal )
+
+/* Fails to compile (negative array size) if the condition is false. */
+#define WS2812B_STATIC_ASSERT(cond, name) typedef char name[( cond ) ? 1 : -1]
+
+#define RESET_LOW_TIME_US 50u
+#define NUM_BITS_IN_BITMASK 16u
+#define BITMASK_MSB 0x8000u
+#define GAMMA_LUT_SIZE 256u
+
+/* Palette storage, see ws2812b.h. Pixel n's index is in byte n / 2, the even pixel in the high nibble. */
+#define PALETTE_INDEX_MASK 0x0Fu
+#define PALETTE_HIGH_NIBBLE_SHIFT 4u
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_PALETTE )
+#define WS2812B_STORAGE_INDEX(pixelIndex) ( ( pixelIndex ) >> 1u ) // Buffer element holding a pixel
+#else
+#define WS2812B_STORAGE_INDEX(pixelIndex) ( pixelIndex )
+#endif
+
+
+#if ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_BITBANG )
+
+/* Bit timing in instruction cycles. The high time of each code is counted from the
+ * WS2812B_PIN_HIGH() instruction to the WS2812B_PIN_LOW() instruction, and the low time from
+ * WS2812B_PIN_LOW() to the next WS2812B_PIN_HIGH(). These MUST be kept in sync with the
+ * WS2812B_CYCLE() counts in WRITE_ONE, WRITE_ZERO, and WRITE_BIT below by hand. The budget asserts
+ * further down only check these numbers against the datasheet, they never see the generated code.
+ */
+#define WRITE_ONE_HIGH_CYCLES 6u
+#define WRITE_ONE_LOW_CYCLES 3u
+#define WRITE_ZERO_HIGH_CYCLES 3u
+#define WRITE_ZERO_LOW_CYCLES 6u
+
+/* Byte gap budgets in cycles, for the C between two WRITE_BYTEs. These are estimates of the XC8
+ * output, not measurements, and the asserts below only check that gaps this long would keep every
+ * low time under WS2812B_MAX_LOW_NS (33 cycles at most per gap). Only
+ * test/host/check_bitbang_listing.awk looks at the real code: it counts the gaps in the listing of
+ * WS2812B_TransmitFrame and fails if one is over budget. No build step runs it, so run it by hand
+ * (make -C test/host listing LST=...) after changing the compiler, the optimization level, or
+ * WS2812B_TransmitFrame.
+ */
+#define GAMMA_LUT_LOOKUP_CYCLES 8u // One flash table read through an FSR, including the bank select
+#define BYTE_BOUNDARY_OVERHEAD_CYCLES 4u // Fetch of the next corrected byte into the bit test register
+#define PIXEL_BOUNDARY_OVERHEAD_CYCLES 28u // Next pixel's palette entry from its index nibble, less for an RGB build
+#define PIXEL_LOOP_OVERHEAD_CYCLES 8u // Increment and compare of the pixel counter, and the branch back
+#define BYTE_LOAD_CYCLES ( BYTE_BOUNDARY_OVERHEAD_CYCLES + GAMMA_LUT_LOOKUP_CYCLES ) // Fetch and correct one byte.
+
+/* Worst case gaps, see WS2812B_TransmitFrame. Green to red corrects both remaining bytes, red to
+ * blue looks up the next pixel, blue to the next green loops and corrects one byte. */
+#define GREEN_TO_RED_GAP_CYCLES ( 2u * BYTE_LOAD_CYCLES )
+#define RED_TO_BLUE_GAP_CYCLES ( BYTE_BOUNDARY_OVERHEAD_CYCLES + PIXEL_BOUNDARY_OVERHEAD_CYCLES )
+#define BLUE_TO_GREEN_GAP_CYCLES ( PIXEL_LOOP_OVERHEAD_CYCLES + BYTE_LOAD_CYCLES )
+
+/* Pin and cycle primitives every waveform macro is built from. They default to the pin manager
+ * and the XC8 NOP builtin. A build for another target, such as the waveform recorder in
+ * test/host, can define them before this point so that each edge and each cycle can be observed.
+ * WS2812B_PIN_LOW_IF_CLEAR is the btfss/bcf pair, 2 cycles whether or not the pin is dropped. */
+#ifndef WS2812B_PIN_HIGH
+#define WS2812B_PIN_HIGH() DATA_PIN_SetHigh()
+#endif
+#ifndef WS2812B_PIN_LOW
+#define WS2812B_PIN_LOW() DATA_PIN_SetLow()
+#endif
+#ifndef WS2812B_PIN_LOW_IF_CLEAR
+#define WS2812B_PIN_LOW_IF_CLEAR(byte, mask) if( 0u == ( ( byte ) & ( mask ) ) ) { WS2812B_PIN_LOW(); }
+#endif
+#ifndef WS2812B_CYCLE
+#define WS2812B_CYCLE() NOP()
+#endif
+
+/* Single codes. Only used for the reset sequence, since the frame itself goes through WRITE_BIT. */
+#define WRITE_ONE() \
+    WS2812B_PIN_HIGH(); WS2812B_CYCLE(); WS2812B_CYCLE(); WS2812B_CYCLE(); WS2812B_CYCLE(); WS2812B_CYCLE(); \
+    WS2812B_PIN_LOW(); WS2812B_CYCLE(); WS2812B_CYCLE();
+#define WRITE_ZERO() \
+    WS2812B_PIN_HIGH(); WS2812B_CYCLE(); WS2812B_CYCLE(); \
+    WS2812B_PIN_LOW(); WS2812B_CYCLE(); WS2812B_CYCLE(); WS2812B_CYCLE(); WS2812B_CYCLE(); WS2812B_CYCLE();
+
+/* Cycle balanced bit write. The pin is always raised, then conditionally dropped after the
+ * zero code high time, then unconditionally dropped after the one code high time. The bit test
+ * and the conditional write compile to btfss/bcf, which take 2 cycles whether or not the skip is
+ * taken, so both paths produce exactly the WRITE_ONE/WRITE_ZERO waveform without a shift, compare,
+ * or branch. The mask is a constant so each unrolled bit tests a fixed bit position.
+ *
+ * The WRITE_*_CYCLES budgets only describe the wire if every bit compiles to exactly this, with no
+ * bank select in between (the byte has to be in common RAM or LATC's bank):
+ *      bsf     LATC, 2         ; cycle 0, rising edge
+ *      nop
+ *      btfss   byte, n
+ *      bcf     LATC, 2         ; cycle 3, falling edge of a 0 code
+ *      nop
+ *      nop
+ *      bcf     LATC, 2         ; cycle 6, falling edge of a 1 code
+ *      nop
+ *      nop                     ; next bsf at cycle 9
+ * test/host/check_bitbang_listing.awk checks a listing for 24 back to back copies of it. Nothing
+ * else does, the budget asserts below pass whatever XC8 emits.
+ */
+#define WRITE_BIT(byte, mask) \
+    WS2812B_PIN_HIGH(); WS2812B_CYCLE(); WS2812B_PIN_LOW_IF_CLEAR( byte, mask ) \
+    WS2812B_CYCLE(); WS2812B_CYCLE(); WS2812B_PIN_LOW(); WS2812B_CYCLE(); WS2812B_CYCLE();
+
+/* Sends a byte MSB first. */
+#define WRITE_BYTE(byte) \
+    WRITE_BIT( byte, 0x80u ) WRITE_BIT( byte, 0x40u ) WRITE_BIT( byte, 0x20u ) WRITE_BIT( byte, 0x10u ) \
+    WRITE_BIT( byte, 0x08u ) WRITE_BIT( byte, 0x04u ) WRITE_BIT( byte, 0x02u ) WRITE_BIT( byte, 0x01u )
+
+WS2812B_STATIC_ASSERT( IS_WITHIN_TOLERANCE( WRITE_ONE_HIGH_CYCLES, WS2812B_ONE_HIGH_NS ), ws2812b_one_high_budget_out_of_tolerance );
+WS2812B_STATIC_ASSERT( IS_WITHIN_TOLERANCE( WRITE_ONE_LOW_CYCLES, WS2812B_ONE_LOW_NS ), ws2812b_one_low_budget_out_of_tolerance );
+WS2812B_STATIC_ASSERT( IS_WITHIN_TOLERANCE( WRITE_ZERO_HIGH_CYCLES, WS2812B_ZERO_HIGH_NS ), ws2812b_zero_high_budget_out_of_tolerance );
+WS2812B_STATIC_ASSERT( IS_WITHIN_TOLERANCE( WRITE_ZERO_LOW_CYCLES, WS2812B_ZERO_LOW_NS ), ws2812b_zero_low_budget_out_of_tolerance );
+WS2812B_STATIC_ASSERT( CYCLES_TO_NS( WRITE_ZERO_LOW_CYCLES + BLUE_TO_GREEN_GAP_CYCLES ) < WS2812B_MAX_LOW_NS, ws2812b_blue_to_green_gap_budget_too_long );
+WS2812B_STATIC_ASSERT( CYCLES_TO_NS( WRITE_ZERO_LOW_CYCLES + GREEN_TO_RED_GAP_CYCLES ) < WS2812B_MAX_LOW_NS, ws2812b_green_to_red_gap_budget_too_long );
+WS2812B_STATIC_ASSERT( CYCLES_TO_NS( WRITE_ZERO_LOW_CYCLES + RED_TO_BLUE_GAP_CYCLES ) < WS2812B_MAX_LOW_NS, ws2812b_pixel_boundary_gap_budget_too_long );
+
+#elif ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_SPI )
+
+/* MSSP1 in SPI master mode, clock = FOSC/(4 * (SSP1ADD + 1)) = 2.67 MHz, 375 ns per SPI bit.
+ * Each led bit is sent as a 4 bit SPI symbol, so every SPI byte carries exactly 2 led bits.
+ *      1 code = 1100 -> HIGH 750 ns, LOW 750 ns
+ *      0 code = 1000 -> HIGH 375 ns, LOW 1125 ns
+ * The last SPI bit of every symbol is low and SDO holds its last value while the buffer is empty,
+ * so any gap between SPI bytes only stretches a low time. The chip only discriminates codes on the
+ * high time, so the longer low times are checked against the latch threshold instead.
+ */
+#define SPI_CLOCK_DIVIDER_SSPADD 2u
+#define SPI_CYCLES_PER_SYMBOL_BIT ( SPI_CLOCK_DIVIDER_SSPADD + 1u )
+#define SPI_ONE_HIGH_BITS 2u
+#define SPI_ZERO_HIGH_BITS 1u
+#define SPI_BITS_PER_SYMBOL 4u
+#define SPI_MAX_BYTE_GAP_CYCLES 8u // Poll, clear, and reload of SSP1BUF between two SPI bytes.
+
+#define SPI_CON1_MASTER_SSPADD_CLOCK 0x2Au // SSPEN enabled; CKP idle low; SSPM SPI master FOSC/(4*(SSPADD+1))
+#define SPI_STAT_TRANSMIT_ACTIVE_TO_IDLE 0x40u // CKE transmit on active to idle; SMP middle
+#define PPS_OUTPUT_SDO1 0x19u // RxyPPS code for SDO1, PIC16F18326 datasheet PPS output table
+
+/* Reset sequence, matching the bit bang driver: a 1 code and a 0 code, the latch delay, then a 1 code. */
+#define SPI_RESET_ONE_ZERO_SYMBOLS 0xC8u
+#define SPI_RESET_ONE_SYMBOL 0xC0u
+#define SPI_IDLE_LOW_BYTE 0x00u
+
+#define SPI_BIT_NS CYCLES_TO_NS( SPI_CYCLES_PER_SYMBOL_BIT )
+
+WS2812B_STATIC_ASSERT( IS_NS_WITHIN_TOLERANCE( SPI_ONE_HIGH_BITS * SPI_BIT_NS, WS2812B_ONE_HIGH_NS ), ws2812b_spi_one_high_time_out_of_tolerance );
+WS2812B_STATIC_ASSERT( IS_NS_WITHIN_TOLERANCE( SPI_ZERO_HIGH_BITS * SPI_BIT_NS, WS2812B_ZERO_HIGH_NS ), ws2812b_spi_zero_high_time_out_of_tolerance );
+WS2812B_STATIC_ASSERT( ( SPI_BITS_PER_SYMBOL - SPI_ONE_HIGH_BITS ) * SPI_BIT_NS >= WS2812B_ONE_LOW_NS - WS2812B_TOLERANCE_NS, ws2812b_spi_one_low_time_too_short );
+WS2812B_STATIC_ASSERT( ( SPI_BITS_PER_SYMBOL - SPI_ZERO_HIGH_BITS ) * SPI_BIT_NS >= WS2812B_ZERO_LOW_NS - WS2812B_TOLERANCE_NS, ws2812b_spi_zero_low_time_too_short );
+WS2812B_STATIC_ASSERT( ( SPI_BITS_PER_SYMBOL - SPI_ZERO_HIGH_BITS ) * SPI_BIT_NS + CYCLES_TO_NS( SPI_MAX_BYTE_GAP_CYCLES ) < WS2812B_MAX_LOW_NS, ws2812b_spi_byte_gap_too_long );
+
+#elif ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_CLC )
+
+/* Hardware generated waveform. TMR2 runs at FOSC/4 with a 750 ns period and drives both PWM5 and
+ * the MSSP1 clock (SSPM = TMR2 match/2), so SCK1 is phase locked to PWM5 with one led bit per SCK
+ * period (1.5 us). CLC1 in AND-OR mode combines them:
+ *      DATA_PIN = SCK1 AND ( SDO1 OR PWM5 )
+ *      1 code: high for the whole SCK high phase -> HIGH 750 ns, LOW 750 ns
+ *      0 code: high for the PWM5 duty cycle      -> HIGH 375 ns, LOW 1125 ns
+ * SCK1 idles low, so the pin stays low whenever SSP1BUF runs empty and a gap between bytes only
+ * stretches a low time. Inside a pixel the gap is the poll and reload plus the wait for the next
+ * TMR2 match, since interrupts are masked. Between pixels an ISR may run.
+ */
+#define CLC_TMR2_PERIOD_CYCLES 6u
+#define CLC_PWM_DUTY_TOSC 12u // PWM duty resolution is one oscillator period (31.25 ns)
+#define CLC_RELOAD_CYCLES 8u // Poll, clear, and reload of SSP1BUF between two bytes.
+#define CLC_MAX_BYTE_GAP_CYCLES ( CLC_RELOAD_CYCLES + CLC_TMR2_PERIOD_CYCLES ) // The transfer starts on a TMR2 match.
+#define CLC_MAX_PIXEL_GAP_NS 10000u // An ISR may preempt the feed loop for this long between pixels.
+
+#define CLC_PR2 ( CLC_TMR2_PERIOD_CYCLES - 1u )
+#define CLC_T2CON_ON_PRESCALE_1 0x04u // T2OUTPS 1:1; TMR2ON on; T2CKPS 1:1
+#define CLC_CCPTMRS_PWM5_TMR2 0x10u // P5TSEL PWM5 based on TMR2
+#define CLC_PWM5CON_ENABLED 0x80u // PWM5EN enabled; PWM5POL active high
+#define CLC_PWM5DCH ( CLC_PWM_DUTY_TOSC >> 2u )
+#define CLC_PWM5DCL ( ( CLC_PWM_DUTY_TOSC & 0x03u ) << 6u )
+#define CLC_SSP1CON1_MASTER_TMR2 0x23u // SSPEN enabled; CKP idle low; SSPM SPI master TMR2 match/2
+#define CLC_SSP1STAT_TRANSMIT_ACTIVE_TO_IDLE 0x40u // CKE, SDO is stable for the whole SCK high phase
+
+/* CLC1 data inputs, codes from the PIC16F18326 datasheet CLCx data input selection table */
+#define CLC_INPUT_SCK1 0x26u
+#define CLC_INPUT_SDO1 0x25u
+#define CLC_INPUT_PWM5 0x14u
+
+/* Gate sources. CLCxGLSy bits are D4T D4N D3T D3N D2T D2N D1T D1N, and each gate ORs its sources.
+ * Data 1 = SCK1, data 2 = SDO1, data 3 = PWM5. Gates 3 and 4 have no sources, so they are 0.
+ */
+#define CLC_GATE1_SCK1 0x02u
+#define CLC_GATE2_SDO1_OR_PWM5 0x28u
+#define CLC_GATE_NONE 0x00u
+#define CLC_POL_NONE_INVERTED 0x00u
+#define CLC_CON_ENABLED_AND_OR 0x80u // LC1EN enabled; LC1MODE AND-OR
+
+#define PPS_OUTPUT_CLC1OUT 0x04u // RxyPPS code for CLC1OUT, PIC16F18326 datasheet PPS output table
+
+#define CLC_BIT_NS CYCLES_TO_NS( CLC_TMR2_PERIOD_CYCLES )
+#define CLC_PWM_DUTY_NS ( (unsigned long) CLC_PWM_DUTY_TOSC * NS_PER_INSTRUCTION_CYCLE / 4u )
+
+WS2812B_STATIC_ASSERT( CLC_PWM_DUTY_TOSC < 4u * CLC_TMR2_PERIOD_CYCLES, ws2812b_clc_pwm_duty_exceeds_period );
+WS2812B_STATIC_ASSERT( IS_NS_WITHIN_TOLERANCE( CLC_BIT_NS, WS2812B_ONE_HIGH_NS ), ws2812b_clc_one_high_time_out_of_tolerance );
+WS2812B_STATIC_ASSERT( IS_NS_WITHIN_TOLERANCE( CLC_PWM_DUTY_NS, WS2812B_ZERO_HIGH_NS ), ws2812b_clc_zero_high_time_out_of_tolerance );
+WS2812B_STATIC_ASSERT( CLC_BIT_NS >= WS2812B_ONE_LOW_NS - WS2812B_TOLERANCE_NS, ws2812b_clc_one_low_time_too_short );
+WS2812B_STATIC_ASSERT( 2u * CLC_BIT_NS - CLC_PWM_DUTY_NS >= WS2812B_ZERO_LOW_NS - WS2812B_TOLERANCE_NS, ws2812b_clc_zero_low_time_too_short );
+WS2812B_STATIC_ASSERT( 2u * CLC_BIT_NS - CLC_PWM_DUTY_NS + CYCLES_TO_NS( CLC_MAX_BYTE_GAP_CYCLES ) < WS2812B_MAX_LOW_NS, ws2812b_clc_byte_gap_too_long );
+WS2812B_STATIC_ASSERT( 2u * CLC_BIT_NS - CLC_PWM_DUTY_NS + CLC_MAX_PIXEL_GAP_NS < RESET_LOW_TIME_US * 1000u, ws2812b_clc_pixel_gap_would_latch );
+
+#else
+#error "WS2812B_TRANSPORT must be WS2812B_TRANSPORT_BITBANG, WS2812B_TRANSPORT_SPI, or WS2812B_TRANSPORT_CLC"
+#endif
+
+
+
+/****************** Local Variable(s) *********************/
+/* Output byte for every input byte, one row per brightness level. Row n is
+ * round( 255 * ( x / 255 )^2.5 * 2^( n - 3 ) ), so the rows are 1/8, 1/4, 1/2 and full brightness.
+ * const keeps the 1 KB table in program memory. */
+static const uint8_t gammaBrightnessLut[WS2812B_NUM_BRIGHTNESS_LEVELS][GAMMA_LUT_SIZE] = {
+    {
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+        0x00u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u,
+        0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x02u, 0x02u, 0x02u, 0x02u,
+        0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x03u, 0x03u, 0x03u,
+        0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x04u,
+        0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x06u,
+        0x06u, 0x06u, 0x06u, 0x06u, 0x06u, 0x06u, 0x06u, 0x07u, 0x07u, 0x07u, 0x07u, 0x07u, 0x07u, 0x07u, 0x07u, 0x08u,
+        0x08u, 0x08u, 0x08u, 0x08u, 0x08u, 0x08u, 0x08u, 0x09u, 0x09u, 0x09u, 0x09u, 0x09u, 0x09u, 0x09u, 0x0Au, 0x0Au,
+        0x0Au, 0x0Au, 0x0Au, 0x0Au, 0x0Bu, 0x0Bu, 0x0Bu, 0x0Bu, 0x0Bu, 0x0Bu, 0x0Cu, 0x0Cu, 0x0Cu, 0x0Cu, 0x0Cu, 0x0Cu,
+        0x0Du, 0x0Du, 0x0Du, 0x0Du, 0x0Du, 0x0Eu, 0x0Eu, 0x0Eu, 0x0Eu, 0x0Eu, 0x0Eu, 0x0Fu, 0x0Fu, 0x0Fu, 0x0Fu, 0x0Fu,
+        0x10u, 0x10u, 0x10u, 0x10u, 0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x12u, 0x12u, 0x12u, 0x12u, 0x12u, 0x13u, 0x13u,
+        0x13u, 0x13u, 0x14u, 0x14u, 0x14u, 0x14u, 0x15u, 0x15u, 0x15u, 0x15u, 0x16u, 0x16u, 0x16u, 0x16u, 0x17u, 0x17u,
+        0x17u, 0x17u, 0x18u, 0x18u, 0x18u, 0x18u, 0x19u, 0x19u, 0x19u, 0x19u, 0x1Au, 0x1Au, 0x1Au, 0x1Bu, 0x1Bu, 0x1Bu,
+        0x1Bu, 0x1Cu, 0x1Cu, 0x1Cu, 0x1Du, 0x1Du, 0x1Du, 0x1Du, 0x1Eu, 0x1Eu, 0x1Eu, 0x1Fu, 0x1Fu, 0x1Fu, 0x20u, 0x20u
+    },
+    {
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u,
+        0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u,
+        0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+        0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x04u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u,
+        0x06u, 0x06u, 0x06u, 0x06u, 0x06u, 0x06u, 0x06u, 0x07u, 0x07u, 0x07u, 0x07u, 0x07u, 0x07u, 0x08u, 0x08u, 0x08u,
+        0x08u, 0x08u, 0x09u, 0x09u, 0x09u, 0x09u, 0x09u, 0x09u, 0x0Au, 0x0Au, 0x0Au, 0x0Au, 0x0Bu, 0x0Bu, 0x0Bu, 0x0Bu,
+        0x0Bu, 0x0Cu, 0x0Cu, 0x0Cu, 0x0Cu, 0x0Du, 0x0Du, 0x0Du, 0x0Du, 0x0Du, 0x0Eu, 0x0Eu, 0x0Eu, 0x0Eu, 0x0Fu, 0x0Fu,
+        0x0Fu, 0x10u, 0x10u, 0x10u, 0x10u, 0x11u, 0x11u, 0x11u, 0x11u, 0x12u, 0x12u, 0x12u, 0x13u, 0x13u, 0x13u, 0x14u,
+        0x14u, 0x14u, 0x15u, 0x15u, 0x15u, 0x15u, 0x16u, 0x16u, 0x16u, 0x17u, 0x17u, 0x17u, 0x18u, 0x18u, 0x19u, 0x19u,
+        0x19u, 0x1Au, 0x1Au, 0x1Au, 0x1Bu, 0x1Bu, 0x1Bu, 0x1Cu, 0x1Cu, 0x1Du, 0x1Du, 0x1Du, 0x1Eu, 0x1Eu, 0x1Fu, 0x1Fu,
+        0x1Fu, 0x20u, 0x20u, 0x21u, 0x21u, 0x21u, 0x22u, 0x22u, 0x23u, 0x23u, 0x24u, 0x24u, 0x24u, 0x25u, 0x25u, 0x26u,
+        0x26u, 0x27u, 0x27u, 0x28u, 0x28u, 0x29u, 0x29u, 0x2Au, 0x2Au, 0x2Bu, 0x2Bu, 0x2Cu, 0x2Cu, 0x2Du, 0x2Du, 0x2Eu,
+        0x2Eu, 0x2Fu, 0x2Fu, 0x30u, 0x30u, 0x31u, 0x31u, 0x32u, 0x32u, 0x33u, 0x33u, 0x34u, 0x35u, 0x35u, 0x36u, 0x36u,
+        0x37u, 0x37u, 0x38u, 0x39u, 0x39u, 0x3Au, 0x3Au, 0x3Bu, 0x3Bu, 0x3Cu, 0x3Du, 0x3Du, 0x3Eu, 0x3Fu, 0x3Fu, 0x40u
+    },
+    {
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x01u, 0x01u, 0x01u, 0x01u,
+        0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x02u, 0x02u, 0x02u, 0x02u,
+        0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x04u, 0x04u, 0x04u,
+        0x04u, 0x04u, 0x04u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x05u, 0x06u, 0x06u, 0x06u, 0x06u, 0x06u, 0x07u, 0x07u,
+        0x07u, 0x07u, 0x07u, 0x08u, 0x08u, 0x08u, 0x08u, 0x09u, 0x09u, 0x09u, 0x09u, 0x0Au, 0x0Au, 0x0Au, 0x0Bu, 0x0Bu,
+        0x0Bu, 0x0Bu, 0x0Cu, 0x0Cu, 0x0Cu, 0x0Du, 0x0Du, 0x0Du, 0x0Eu, 0x0Eu, 0x0Eu, 0x0Fu, 0x0Fu, 0x0Fu, 0x10u, 0x10u,
+        0x10u, 0x11u, 0x11u, 0x11u, 0x12u, 0x12u, 0x13u, 0x13u, 0x13u, 0x14u, 0x14u, 0x15u, 0x15u, 0x15u, 0x16u, 0x16u,
+        0x17u, 0x17u, 0x18u, 0x18u, 0x19u, 0x19u, 0x1Au, 0x1Au, 0x1Au, 0x1Bu, 0x1Bu, 0x1Cu, 0x1Cu, 0x1Du, 0x1Eu, 0x1Eu,
+        0x1Fu, 0x1Fu, 0x20u, 0x20u, 0x21u, 0x21u, 0x22u, 0x22u, 0x23u, 0x24u, 0x24u, 0x25u, 0x25u, 0x26u, 0x27u, 0x27u,
+        0x28u, 0x28u, 0x29u, 0x2Au, 0x2Au, 0x2Bu, 0x2Cu, 0x2Cu, 0x2Du, 0x2Eu, 0x2Eu, 0x2Fu, 0x30u, 0x30u, 0x31u, 0x32u,
+        0x32u, 0x33u, 0x34u, 0x35u, 0x35u, 0x36u, 0x37u, 0x38u, 0x38u, 0x39u, 0x3Au, 0x3Bu, 0x3Cu, 0x3Cu, 0x3Du, 0x3Eu,
+        0x3Fu, 0x40u, 0x40u, 0x41u, 0x42u, 0x43u, 0x44u, 0x45u, 0x45u, 0x46u, 0x47u, 0x48u, 0x49u, 0x4Au, 0x4Bu, 0x4Cu,
+        0x4Du, 0x4Eu, 0x4Eu, 0x4Fu, 0x50u, 0x51u, 0x52u, 0x53u, 0x54u, 0x55u, 0x56u, 0x57u, 0x58u, 0x59u, 0x5Au, 0x5Bu,
+        0x5Cu, 0x5Du, 0x5Eu, 0x5Fu, 0x60u, 0x61u, 0x63u, 0x64u, 0x65u, 0x66u, 0x67u, 0x68u, 0x69u, 0x6Au, 0x6Bu, 0x6Cu,
+        0x6Eu, 0x6Fu, 0x70u, 0x71u, 0x72u, 0x73u, 0x75u, 0x76u, 0x77u, 0x78u, 0x79u, 0x7Bu, 0x7Cu, 0x7Du, 0x7Eu, 0x80u
+    },
+    {
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+        0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u,
+        0x01u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x02u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x04u, 0x04u,
+        0x04u, 0x04u, 0x04u, 0x05u, 0x05u, 0x05u, 0x05u, 0x06u, 0x06u, 0x06u, 0x06u, 0x07u, 0x07u, 0x07u, 0x07u, 0x08u,
+        0x08u, 0x08u, 0x09u, 0x09u, 0x09u, 0x0Au, 0x0Au, 0x0Au, 0x0Bu, 0x0Bu, 0x0Cu, 0x0Cu, 0x0Cu, 0x0Du, 0x0Du, 0x0Eu,
+        0x0Eu, 0x0Fu, 0x0Fu, 0x0Fu, 0x10u, 0x10u, 0x11u, 0x11u, 0x12u, 0x12u, 0x13u, 0x13u, 0x14u, 0x14u, 0x15u, 0x16u,
+        0x16u, 0x17u, 0x17u, 0x18u, 0x19u, 0x19u, 0x1Au, 0x1Au, 0x1Bu, 0x1Cu, 0x1Cu, 0x1Du, 0x1Eu, 0x1Eu, 0x1Fu, 0x20u,
+        0x21u, 0x21u, 0x22u, 0x23u, 0x24u, 0x24u, 0x25u, 0x26u, 0x27u, 0x28u, 0x28u, 0x29u, 0x2Au, 0x2Bu, 0x2Cu, 0x2Du,
+        0x2Eu, 0x2Eu, 0x2Fu, 0x30u, 0x31u, 0x32u, 0x33u, 0x34u, 0x35u, 0x36u, 0x37u, 0x38u, 0x39u, 0x3Au, 0x3Bu, 0x3Cu,
+        0x3Du, 0x3Eu, 0x3Fu, 0x40u, 0x41u, 0x43u, 0x44u, 0x45u, 0x46u, 0x47u, 0x48u, 0x49u, 0x4Bu, 0x4Cu, 0x4Du, 0x4Eu,
+        0x50u, 0x51u, 0x52u, 0x53u, 0x55u, 0x56u, 0x57u, 0x59u, 0x5Au, 0x5Bu, 0x5Du, 0x5Eu, 0x5Fu, 0x61u, 0x62u, 0x63u,
+        0x65u, 0x66u, 0x68u, 0x69u, 0x6Bu, 0x6Cu, 0x6Eu, 0x6Fu, 0x71u, 0x72u, 0x74u, 0x75u, 0x77u, 0x79u, 0x7Au, 0x7Cu,
+        0x7Du, 0x7Fu, 0x81u, 0x82u, 0x84u, 0x86u, 0x87u, 0x89u, 0x8Bu, 0x8Du, 0x8Eu, 0x90u, 0x92u, 0x94u, 0x96u, 0x97u,
+        0x99u, 0x9Bu, 0x9Du, 0x9Fu, 0xA1u, 0xA3u, 0xA5u, 0xA6u, 0xA8u, 0xAAu, 0xACu, 0xAEu, 0xB0u, 0xB2u, 0xB4u, 0xB6u,
+        0xB8u, 0xBAu, 0xBDu, 0xBFu, 0xC1u, 0xC3u, 0xC5u, 0xC7u, 0xC9u, 0xCCu, 0xCEu, 0xD0u, 0xD2u, 0xD4u, 0xD7u, 0xD9u,
+        0xDBu, 0xDDu, 0xE0u, 0xE2u, 0xE4u, 0xE7u, 0xE9u, 0xEBu, 0xEEu, 0xF0u, 0xF3u, 0xF5u, 0xF8u, 0xFAu, 0xFDu, 0xFFu
+    }
+};
+
+#if ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_SPI )
+/* SPI byte for every pair of led bits, indexed MSB first: 00, 01, 10, 11 */
+static const uint8_t spiSymbolPairs[4] = {0x88u, 0x8Cu, 0xC8u, 0xCCu};
+#endif
 
 
 
 /****************** Static Function Prototype(s) **********/
-static void WS2812b_RenderSinglePixel( const ws2812bPixel * const pixel );
-static inline void WS2812B_Reset( );
+static void WS2812B_InitializeTransport( void );
+static void WS2812B_TransmitFrame( const ws2812bArray * const strip,
+                                   const size_t numPixels );
+static inline void WS2812B_Reset( void );
+static inline bool WS2812b_HasStorage( const ws2812bArray * const strip );
+static inline const ws2812bPixel * WS2812b_GetPixel( const ws2812bArray * const strip,
+                                                     const size_t pixelIndex );
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_PALETTE )
+static bool WS2812b_WritePaletteIndex( ws2812bStorage * const buffer,
+                                       const size_t pixelIndex,
+                                       const uint8_t paletteIndex );
+#endif
+static void WS2812b_MarkDirty( ws2812bArray * const strip,
+                               const size_t startIndex,
+                               const size_t numPixels );
+static void WS2812b_WidenRange( size_t * const rangeStart,
+                                size_t * const rangeEnd,
+                                const size_t startIndex,
+                                const size_t numPixels );
 
 /*********************** Function(s) **********************/
 
-ws2812bArray WS2812b_Initialize( ws2812bPixel * pxBuff,
+ws2812bArray WS2812b_Initialize( ws2812bStorage * pxBuff,
                                  const size_t numElements,
                                  bool * const wasSetupSuccessful )
 {
     ws2812bArray array;
     array.pixelBuffer = pxBuff;
+    array.frontBuffer = pxBuff;
     array.numPixels = numElements;
+    array.dirtyStartIndex = 0u;
+    array.dirtyEndIndex = numElements;
+    array.flipMode = WS2812B_FLIP_SWAP;
+    array.backDirtyStartIndex = 0u;
+    array.backDirtyEndIndex = 0u;
+    array.brightnessLevel = WS2812B_MAX_BRIGHTNESS_LEVEL;
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_PALETTE )
+    memset( array.palette, 0, sizeof (array.palette ) );
+#endif
     *wasSetupSuccessful = ( ( NULL == pxBuff ) || ( 0 == numElements ) ) ? false : true;
+    WS2812B_InitializeTransport( );
+    return array;
+}
+
+ws2812bArray WS2812b_InitializeDoubleBuffered( ws2812bStorage * backBuff,
+                                               ws2812bStorage * frontBuff,
+                                               const size_t numElements,
+                                               const WS2812B_FLIP_MODE flipMode,
+                                               bool * const wasSetupSuccessful )
+{
+    ws2812bArray array = WS2812b_Initialize( backBuff, numElements, wasSetupSuccessful );
+    array.frontBuffer = frontBuff;
+    array.flipMode = flipMode;
+    /* The buffers start out unrelated, so the first flip has to sync all of them */
+    array.backDirtyStartIndex = 0u;
+    array.backDirtyEndIndex = numElements;
+    if( ( NULL == frontBuff ) || ( frontBuff == backBuff ) )
+    {
+        *wasSetupSuccessful = false;
+    }
     return array;
 }
 
@@ -53,78 +399,440 @@ ws2812bArray WS2812b_Initialize( ws2812bPixel * pxBuff,
 
 
 
-void WS2812B_Render( const ws2812bArray * const strip )
+void WS2812B_Render( ws2812bArray * const strip,
+                     const bool forceRender )
 {
     if( ( NULL == strip ) ||
-        ( NULL == strip->pixelBuffer ) )
+        ( !WS2812b_HasStorage( strip ) ) ||
+        ( 0u == strip->numPixels ) )
+    {
+        return;
+    }
+
+    /* Nothing changed since the last transmit */
+    if( ( !forceRender ) &&
+        ( strip->dirtyStartIndex == strip->dirtyEndIndex ) )
+    {
+        return;
+    }
+
+    WS2812B_TransmitFrame( strip, strip->numPixels );
+    strip->dirtyStartIndex = 0u;
+    strip->dirtyEndIndex = 0u;
+    return;
+}
+
+void WS2812B_RenderDirtyPrefix( ws2812bArray * const strip )
+{
+    if( ( NULL == strip ) ||
+        ( !WS2812b_HasStorage( strip ) ) ||
+        ( strip->dirtyStartIndex == strip->dirtyEndIndex ) )
+    {
+        return;
+    }
+
+    WS2812B_TransmitFrame( strip, strip->dirtyEndIndex );
+    strip->dirtyStartIndex = 0u;
+    strip->dirtyEndIndex = 0u;
+    return;
+}
+
+void WS2812B_SetBrightness( ws2812bArray * const strip,
+                            const uint8_t brightnessLevel )
+{
+    if( ( NULL == strip ) ||
+        ( brightnessLevel > WS2812B_MAX_BRIGHTNESS_LEVEL ) ||
+        ( brightnessLevel == strip->brightnessLevel ) )
+    {
+        return;
+    }
+
+    /* No pixel changes, only the frame on the strip is stale. Mark it without touching any buffer. */
+    strip->brightnessLevel = brightnessLevel;
+    strip->dirtyStartIndex = 0u;
+    strip->dirtyEndIndex = strip->numPixels;
+    return;
+}
+
+void WS2812B_FlipBuffers( ws2812bArray * const strip )
+{
+    if( ( NULL == strip ) ||
+        ( !WS2812b_HasStorage( strip ) ) ||
+        ( strip->pixelBuffer == strip->frontBuffer ) )
     {
         return;
     }
 
+    /* Nothing was composed, so the back buffer already matches the front */
+    if( ( WS2812B_FLIP_COPY_DIRTY == strip->flipMode ) &&
+        ( strip->backDirtyStartIndex == strip->backDirtyEndIndex ) )
+    {
+        return;
+    }
+
+    /* A transmit running from an interrupt must never see half of a pointer swap */
+    INTERRUPT_GlobalInterruptDisable( );
+    ws2812bStorage * composedFrame = strip->pixelBuffer;
+    strip->pixelBuffer = strip->frontBuffer;
+    strip->frontBuffer = composedFrame;
+    INTERRUPT_GlobalInterruptEnable( );
+
+    if( WS2812B_FLIP_COPY_DIRTY == strip->flipMode )
+    {
+        /* Bring the new back buffer up to date. Everything outside the range already matched, so
+         * a palette byte shared with a pixel outside it can be copied whole. */
+        size_t firstElement = WS2812B_STORAGE_INDEX( strip->backDirtyStartIndex );
+        size_t endElement = WS2812B_STORAGE_SIZE( strip->backDirtyEndIndex );
+        memcpy( &( strip->pixelBuffer[firstElement] ),
+                &( strip->frontBuffer[firstElement] ),
+                ( endElement - firstElement ) * sizeof (ws2812bStorage ) );
+        WS2812b_WidenRange( &( strip->dirtyStartIndex ),
+                            &( strip->dirtyEndIndex ),
+                            strip->backDirtyStartIndex,
+                            strip->backDirtyEndIndex - strip->backDirtyStartIndex );
+    }
+    else
+    {
+        /* The back buffer held the frame before last, so skipped writes can hide changes anywhere */
+        strip->dirtyStartIndex = 0u;
+        strip->dirtyEndIndex = strip->numPixels;
+    }
+    strip->backDirtyStartIndex = 0u;
+    strip->backDirtyEndIndex = 0u;
+    return;
+}
+
+/* Function:
+ *      WS2812b_HasStorage
+ *
+ * Description:
+ *      True if the strip's compose and transmit buffers are linked.
+ */
+static inline bool WS2812b_HasStorage( const ws2812bArray * const strip )
+{
+    return ( NULL != strip->pixelBuffer ) && ( NULL != strip->frontBuffer );
+}
+
+/* Function:
+ *      WS2812b_GetPixel
+ *
+ * Description:
+ *      Returns the color to send for a pixel, from the buffer the render functions transmit. With
+ *      palette storage this is the palette entry the pixel's index nibble points at.
+ */
+static inline const ws2812bPixel * WS2812b_GetPixel( const ws2812bArray * const strip,
+                                                     const size_t pixelIndex )
+{
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_PALETTE )
+    uint8_t paletteIndex = strip->frontBuffer[WS2812B_STORAGE_INDEX( pixelIndex )];
+    if( 0u == ( pixelIndex & 1u ) )
+    {
+        paletteIndex >>= PALETTE_HIGH_NIBBLE_SHIFT;
+    }
+    return &( strip->palette[paletteIndex & PALETTE_INDEX_MASK] );
+#else
+    return &( strip->frontBuffer[pixelIndex] );
+#endif
+}
+
+
+#if ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_BITBANG )
+
+/* Bit bang transport needs no setup, DATA_PIN is configured by the pin manager. */
+static void WS2812B_InitializeTransport( void )
+{
+    return;
+}
+
+/* Function:
+ *      WS2812B_TransmitFrame
+ *
+ * Description:
+ *      Bit bangs the pixels out of DATA_PIN. Interrupts are disabled for the entire frame.
+ */
+static void WS2812B_TransmitFrame( const ws2812bArray * const strip,
+                                   const size_t numPixels )
+{
     /* Disable interrupts to avoid incomplete renders */
     INTERRUPT_GlobalInterruptDisable( );
     INTERRUPT_PeripheralInterruptDisable( );
 
     size_t i;
-    ws2812bPixel * thisPixel = strip->pixelBuffer;
-    for( i = 0; i < strip->numPixels; i++ )
+    uint8_t thisByte;
+    uint8_t blueByte;
+    const uint8_t * gammaLut = gammaBrightnessLut[strip->brightnessLevel];
+    const ws2812bPixel * thisPixel = WS2812b_GetPixel( strip, 0u );
+    for( i = 1u; i <= numPixels; i++ )
     {
-        size_t j;
-        for( j = 0; j < NUM_BITS_IN_BYTE; j++ )
+        /* Wire order is green, red, blue. The table reads and the next pixel lookup are spread
+         * over separate gaps so no single low time gets both. */
+        thisByte = gammaLut[thisPixel->green];
+        WRITE_BYTE( thisByte );
+        thisByte = gammaLut[thisPixel->red];
+        blueByte = gammaLut[thisPixel->blue];
+        WRITE_BYTE( thisByte );
+        thisByte = blueByte;
+        if( i < numPixels )
         {
-            if( ( thisPixel->green << j ) & 0x80u )
-            {
-                WRITE_ONE( );
-            }
-            else
-            {
-                WRITE_ZERO( );
-            }
-        }
-        for( j = 0; j < NUM_BITS_IN_BYTE; j++ )
-        {
-            if( ( thisPixel->red << j ) & 0x80u )
-            {
-                WRITE_ONE( );
-            }
-            else
-            {
-                WRITE_ZERO( );
-            }
-        }
-        for( j = 0; j < NUM_BITS_IN_BYTE; j++ )
-        {
-            if( ( thisPixel->blue << j ) & 0x80u )
-            {
-                WRITE_ONE( );
-            }
-            else
-            {
-                WRITE_ZERO( );
-            }
+            thisPixel = WS2812b_GetPixel( strip, i );
         }
+        WRITE_BYTE( thisByte );
+    }
 
-        thisPixel++;
+    WS2812B_Reset( );
 
-    }
+    INTERRUPT_GlobalInterruptEnable( );
+    INTERRUPT_PeripheralInterruptEnable( );
+    return;
+}
 
-    /* Reset back to 0th index */
+/* Function:
+ *      WS2812B_Reset
+ *
+ * Description:
+ *      Latches the shifted frame and resets the strip back to the 0th index.
+ */
+static inline void WS2812B_Reset( void )
+{
     WRITE_ONE( );
     WRITE_ZERO( );
-    __delay_us( 50 );
+    __delay_us( RESET_LOW_TIME_US );
     WRITE_ONE( );
+    return;
+}
+
+#endif
 
+
+#if ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_SPI ) || ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_CLC )
+
+/* Function:
+ *      WS2812B_SpiWrite
+ *
+ * Description:
+ *      Waits for the byte currently shifting out to finish, then loads the next one. The next byte
+ *      must already be encoded so the gap between SPI bytes is only the poll and reload.
+ */
+static inline void WS2812B_SpiWrite( const uint8_t spiByte )
+{
+    while( !SSP1STATbits.BF )
+    {
+    }
+    (void) SSP1BUF;
+    SSP1BUF = spiByte;
+    return;
+}
+
+#endif
+
+
+#if ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_SPI )
+
+/* Function:
+ *      WS2812B_InitializeTransport
+ *
+ * Description:
+ *      Routes SDO1 to DATA_PIN and starts MSSP1 as an SPI master at the symbol bit rate.
+ */
+static void WS2812B_InitializeTransport( void )
+{
+    DATA_PIN_SetLow( );
+    RC2PPS = PPS_OUTPUT_SDO1;
+    SSP1STAT = SPI_STAT_TRANSMIT_ACTIVE_TO_IDLE;
+    SSP1ADD = SPI_CLOCK_DIVIDER_SSPADD;
+    SSP1CON1 = SPI_CON1_MASTER_SSPADD_CLOCK;
+    return;
+}
+
+/* Function:
+ *      WS2812B_SpiWriteSymbols
+ *
+ * Description:
+ *      Sends one corrected byte as four SPI symbol pairs, MSB first. Each symbol is looked up while
+ *      the previous SPI byte (24 cycles) is still shifting out.
+ */
+static inline void WS2812B_SpiWriteSymbols( const uint8_t wireByte )
+{
+    WS2812B_SpiWrite( spiSymbolPairs[wireByte >> 6u] );
+    WS2812B_SpiWrite( spiSymbolPairs[( wireByte >> 4u ) & 0x03u] );
+    WS2812B_SpiWrite( spiSymbolPairs[( wireByte >> 2u ) & 0x03u] );
+    WS2812B_SpiWrite( spiSymbolPairs[wireByte & 0x03u] );
+    return;
+}
+
+/* Function:
+ *      WS2812B_TransmitFrame
+ *
+ * Description:
+ *      Streams the pixels through SSP1BUF as SPI symbols. Every byte is corrected, and the next
+ *      pixel looked up, while the previous SPI byte shifts out, so inside a pixel the gaps are only
+ *      the poll and reload. Interrupts are only masked while a single pixel is shifting out
+ *      (12 SPI bytes, about 48 us with the reload gaps). Between pixels an ISR may run, which only
+ *      stretches the low time of the last bit, so every ISR must finish well within the latch time.
+ */
+static void WS2812B_TransmitFrame( const ws2812bArray * const strip,
+                                   const size_t numPixels )
+{
+    size_t i;
+    uint8_t blueByte;
+    const uint8_t * gammaLut = gammaBrightnessLut[strip->brightnessLevel];
+    const ws2812bPixel * thisPixel = WS2812b_GetPixel( strip, 0u );
+
+    /* Clear any stale buffer full flag, then prime the buffer with an all low byte so every
+     * write can wait on the previous one. */
+    (void) SSP1BUF;
+    SSP1BUF = SPI_IDLE_LOW_BYTE;
+
+    for( i = 1u; i <= numPixels; i++ )
+    {
+        /* Wire order is green, red, blue */
+        INTERRUPT_GlobalInterruptDisable( );
+        WS2812B_SpiWriteSymbols( gammaLut[thisPixel->green] );
+        WS2812B_SpiWriteSymbols( gammaLut[thisPixel->red] );
+        blueByte = gammaLut[thisPixel->blue];
+        if( i < numPixels )
+        {
+            thisPixel = WS2812b_GetPixel( strip, i );
+        }
+        WS2812B_SpiWriteSymbols( blueByte );
+        INTERRUPT_GlobalInterruptEnable( );
+    }
+
+    WS2812B_Reset( );
+    return;
+}
+
+/* Function:
+ *      WS2812B_Reset
+ *
+ * Description:
+ *      Latches the shifted frame and resets the strip back to the 0th index. Same sequence as the
+ *      bit bang driver so both transports put identical frames on the wire.
+ */
+static inline void WS2812B_Reset( void )
+{
+    WS2812B_SpiWrite( SPI_RESET_ONE_ZERO_SYMBOLS );
+    WS2812B_SpiWrite( SPI_IDLE_LOW_BYTE );
+    __delay_us( RESET_LOW_TIME_US );
+    WS2812B_SpiWrite( SPI_RESET_ONE_SYMBOL );
+    return;
+}
+
+#elif ( WS2812B_TRANSPORT == WS2812B_TRANSPORT_CLC )
+
+/* Function:
+ *      WS2812B_InitializeTransport
+ *
+ * Description:
+ *      Starts TMR2, PWM5, and MSSP1, then combines them through CLC1 and routes CLC1OUT to DATA_PIN.
+ */
+static void WS2812B_InitializeTransport( void )
+{
+    DATA_PIN_SetLow( );
+
+    /* Shared timebase for the SPI clock and the zero code pulse */
+    T2CON = 0x00u;
+    TMR2 = 0x00u;
+    PR2 = CLC_PR2;
+    CCPTMRS = ( CCPTMRS & 0xCFu ) | CLC_CCPTMRS_PWM5_TMR2;
+    PWM5DCH = CLC_PWM5DCH;
+    PWM5DCL = CLC_PWM5DCL;
+    PWM5CON = CLC_PWM5CON_ENABLED;
+    T2CON = CLC_T2CON_ON_PRESCALE_1;
+
+    /* Bit clock and data */
+    SSP1STAT = CLC_SSP1STAT_TRANSMIT_ACTIVE_TO_IDLE;
+    SSP1CON1 = CLC_SSP1CON1_MASTER_TMR2;
+
+    /* DATA_PIN = SCK1 AND ( SDO1 OR PWM5 ) */
+    CLC1CON = 0x00u;
+    CLC1SEL0 = CLC_INPUT_SCK1;
+    CLC1SEL1 = CLC_INPUT_SDO1;
+    CLC1SEL2 = CLC_INPUT_PWM5;
+    CLC1SEL3 = CLC_INPUT_PWM5;
+    CLC1GLS0 = CLC_GATE1_SCK1;
+    CLC1GLS1 = CLC_GATE2_SDO1_OR_PWM5;
+    CLC1GLS2 = CLC_GATE_NONE;
+    CLC1GLS3 = CLC_GATE_NONE;
+    CLC1POL = CLC_POL_NONE_INVERTED;
+    CLC1CON = CLC_CON_ENABLED_AND_OR;
+
+    RC2PPS = PPS_OUTPUT_CLC1OUT;
+    return;
+}
+
+/* Function:
+ *      WS2812B_TransmitFrame
+ *
+ * Description:
+ *      Feeds the pixel bytes to SSP1BUF, one led bit per SPI bit. The waveform is generated entirely
+ *      by hardware, each byte takes 12 us to shift out. Interrupts are only masked while the three
+ *      bytes of a pixel are fed, so an ISR can't hold a byte back inside a pixel. Between pixels an
+ *      ISR may run, which only stretches the low time of the last bit.
+ */
+static void WS2812B_TransmitFrame( const ws2812bArray * const strip,
+                                   const size_t numPixels )
+{
+    size_t i;
+    const ws2812bPixel * thisPixel = WS2812b_GetPixel( strip, 0u );
+    const uint8_t * gammaLut = gammaBrightnessLut[strip->brightnessLevel];
+
+    /* Clear any stale buffer full flag. The first byte has nothing to wait on. */
+    (void) SSP1BUF;
+    INTERRUPT_GlobalInterruptDisable( );
+    SSP1BUF = gammaLut[thisPixel->green];
+    WS2812B_SpiWrite( gammaLut[thisPixel->red] );
+    WS2812B_SpiWrite( gammaLut[thisPixel->blue] );
     INTERRUPT_GlobalInterruptEnable( );
-    INTERRUPT_PeripheralInterruptEnable( );
+
+    for( i = 1; i < numPixels; i++ )
+    {
+        /* Wire order is green, red, blue. The lookup runs while the last byte shifts out. */
+        thisPixel = WS2812b_GetPixel( strip, i );
+        INTERRUPT_GlobalInterruptDisable( );
+        WS2812B_SpiWrite( gammaLut[thisPixel->green] );
+        WS2812B_SpiWrite( gammaLut[thisPixel->red] );
+        WS2812B_SpiWrite( gammaLut[thisPixel->blue] );
+        INTERRUPT_GlobalInterruptEnable( );
+    }
+
+    WS2812B_Reset( );
     return;
 }
 
+/* Function:
+ *      WS2812B_Reset
+ *
+ * Description:
+ *      Waits for the last byte to shift out, then holds the line low to latch the frame.
+ *
+ *      This differs from the other transports on purpose. They follow the frame with a 1 and a 0
+ *      code, the latch, and another 1 code. The first two codes shift out past the last pixel and
+ *      the last one is dropped by the reset before the next frame, so none of them change what the
+ *      strip shows. Here every SPI bit is a whole led code, so codes can only be sent 8 at a time.
+ *      8 codes after the latch would be a third of the first pixel's next color, and the reset
+ *      before the next frame would be all that kept them off the strip. The latch alone is sent.
+ */
+static inline void WS2812B_Reset( void )
+{
+    while( !SSP1STATbits.BF )
+    {
+    }
+    (void) SSP1BUF;
+    __delay_us( RESET_LOW_TIME_US );
+    return;
+}
+
+#endif
+
 
 /****************************************************************************************************/
 /************                       RGB Pixel Modification Section  *********************************/
 
 /****************************************************************************************************/
 
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_RGB )
+
 
 void WS2812b_SetSinglePixelColor( ws2812bArray * const strip,
                                   const size_t pixelIndex,
@@ -134,7 +842,7 @@ void WS2812b_SetSinglePixelColor( ws2812bArray * const strip,
 {
     if( ( NULL == strip ) ||
         ( NULL == strip->pixelBuffer ) ||
-        ( pixelIndex > strip->numPixels ) )
+        ( pixelIndex >= strip->numPixels ) )
     {
         return;
     }
@@ -146,13 +854,22 @@ void WS2812b_SetSinglePixelColor( ws2812bArray * const strip,
         return;
     }
 
+    /* Rewriting the same color doesn't dirty the frame */
+    if( ( red == thisPixel->red ) &&
+        ( green == thisPixel->green ) &&
+        ( blue == thisPixel->blue ) )
+    {
+        return;
+    }
+
     thisPixel->red = red;
     thisPixel->green = green;
     thisPixel->blue = blue;
+    WS2812b_MarkDirty( strip, pixelIndex, 1u );
     return;
 }
 
-void WS2812b_SetPixelBlockFromRGBArray( const ws2812bArray * const strip,
+void WS2812b_SetPixelBlockFromRGBArray( ws2812bArray * const strip,
                                         const size_t pixelStartOffset,
                                         const size_t numPixelsToSet,
                                         const uint8_t * const rgbArray )
@@ -172,11 +889,12 @@ void WS2812b_SetPixelBlockFromRGBArray( const ws2812bArray * const strip,
     }
 
     uint8_t * startPixelAddress = &( strip->pixelBuffer[pixelStartOffset].red );
-    memcpy( startPixelAddress, rgbArray, numPixelsToSet );
+    memcpy( startPixelAddress, rgbArray, numPixelsToSet * NUM_BYTES_IN_PIXEL );
+    WS2812b_MarkDirty( strip, pixelStartOffset, numPixelsToSet );
     return;
 }
 
-void WS2812b_SetPixelBlockConstantColor( const ws2812bArray * const strip,
+void WS2812b_SetPixelBlockConstantColor( ws2812bArray * const strip,
                                          const size_t pixelStartOffset,
                                          const size_t numPixelsToSet,
                                          const uint8_t red,
@@ -203,6 +921,47 @@ void WS2812b_SetPixelBlockConstantColor( const ws2812bArray * const strip,
     {
         memcpy( ( startPixelAddress + NUM_BYTES_IN_PIXEL * i ), rgbArray, NUM_BYTES_IN_PIXEL );
     }
+    WS2812b_MarkDirty( strip, pixelStartOffset, numPixelsToSet );
+    return;
+}
+
+void WS2812b_SetPixelBlockFromBitmask( ws2812bArray * const strip,
+                                       const size_t pixelStartOffset,
+                                       const size_t numPixelsToSet,
+                                       const uint16_t bitmask,
+                                       const uint8_t * const setRGB,
+                                       const uint8_t * const clearRGB )
+{
+    if( ( NULL == strip ) ||
+        ( NULL == strip->pixelBuffer ) ||
+        ( NULL == setRGB ) ||
+        ( NULL == clearRGB ) ||
+        ( numPixelsToSet > NUM_BITS_IN_BITMASK ) ||
+        ( pixelStartOffset + numPixelsToSet > strip->numPixels ) )
+    {
+        return;
+    }
+
+    size_t i;
+    bool wasModified = false;
+    uint16_t thisBit = BITMASK_MSB;
+    uint8_t * thisPixelAddress = &( strip->pixelBuffer[pixelStartOffset].red );
+    for( i = 0; i < numPixelsToSet; i++ )
+    {
+        const uint8_t * thisColor = ( bitmask & thisBit ) ? setRGB : clearRGB;
+        if( 0 != memcmp( thisPixelAddress, thisColor, NUM_BYTES_IN_PIXEL ) )
+        {
+            memcpy( thisPixelAddress, thisColor, NUM_BYTES_IN_PIXEL );
+            wasModified = true;
+        }
+        thisPixelAddress += NUM_BYTES_IN_PIXEL;
+        thisBit >>= 1u;
+    }
+
+    if( wasModified )
+    {
+        WS2812b_MarkDirty( strip, pixelStartOffset, numPixelsToSet );
+    }
     return;
 }
 
@@ -225,7 +984,7 @@ void WS2812b_SetStripConstantColor( ws2812bArray * const strip,
     return;
 }
 
-void WS2812b_CopyPixelBufferArrayFromSource( const ws2812bArray * const strip,
+void WS2812b_CopyPixelBufferArrayFromSource( ws2812bArray * const strip,
                                              ws2812bPixel * const pixelSource,
                                              const size_t startAddress,
                                              const size_t numPixelsToCopy )
@@ -243,7 +1002,245 @@ void WS2812b_CopyPixelBufferArrayFromSource( const ws2812bArray * const strip,
     uint8_t * dest = &( startPixel->red );
     uint8_t * src = &( pixelSource->red );
 
+    /* Copying identical pixels doesn't dirty the frame */
+    if( 0 == memcmp( dest, src, numPixelsToCopy * NUM_BYTES_IN_PIXEL ) )
+    {
+        return;
+    }
+
     memcpy( dest, src, numPixelsToCopy * NUM_BYTES_IN_PIXEL );
+    WS2812b_MarkDirty( strip, startAddress, numPixelsToCopy );
+    return;
+}
+
+#else
+
+/****************************************************************************************************/
+/************                       Palette Modification Section  ***********************************/
+
+/****************************************************************************************************/
+
+
+void WS2812b_SetPaletteColor( ws2812bArray * const strip,
+                              const uint8_t paletteIndex,
+                              const uint8_t red,
+                              const uint8_t green,
+                              const uint8_t blue )
+{
+    if( ( NULL == strip ) ||
+        ( paletteIndex >= WS2812B_PALETTE_SIZE ) )
+    {
+        return;
+    }
+
+    ws2812bPixel * thisEntry = &( strip->palette[paletteIndex] );
+
+    if( ( red == thisEntry->red ) &&
+        ( green == thisEntry->green ) &&
+        ( blue == thisEntry->blue ) )
+    {
+        return;
+    }
+
+    /* Both buffers index the palette, so the frame on the strip is stale without any flip. Mark it
+     * like a brightness change. */
+    thisEntry->red = red;
+    thisEntry->green = green;
+    thisEntry->blue = blue;
+    strip->dirtyStartIndex = 0u;
+    strip->dirtyEndIndex = strip->numPixels;
+    return;
+}
+
+void WS2812b_SetSinglePixelPaletteIndex( ws2812bArray * const strip,
+                                         const size_t pixelIndex,
+                                         const uint8_t paletteIndex )
+{
+    if( ( NULL == strip ) ||
+        ( NULL == strip->pixelBuffer ) ||
+        ( pixelIndex >= strip->numPixels ) ||
+        ( paletteIndex >= WS2812B_PALETTE_SIZE ) )
+    {
+        return;
+    }
+
+    if( WS2812b_WritePaletteIndex( strip->pixelBuffer, pixelIndex, paletteIndex ) )
+    {
+        WS2812b_MarkDirty( strip, pixelIndex, 1u );
+    }
+    return;
+}
+
+void WS2812b_SetPixelBlockPaletteIndex( ws2812bArray * const strip,
+                                        const size_t pixelStartOffset,
+                                        const size_t numPixelsToSet,
+                                        const uint8_t paletteIndex )
+{
+    if( ( NULL == strip ) ||
+        ( NULL == strip->pixelBuffer ) ||
+        ( pixelStartOffset + numPixelsToSet > strip->numPixels ) ||
+        ( paletteIndex >= WS2812B_PALETTE_SIZE ) )
+    {
+        return;
+    }
+
+    size_t i;
+    bool wasModified = false;
+    for( i = pixelStartOffset; i < pixelStartOffset + numPixelsToSet; i++ )
+    {
+        wasModified |= WS2812b_WritePaletteIndex( strip->pixelBuffer, i, paletteIndex );
+    }
+
+    if( wasModified )
+    {
+        WS2812b_MarkDirty( strip, pixelStartOffset, numPixelsToSet );
+    }
+    return;
+}
+
+void WS2812b_SetPixelBlockFromBitmaskPaletteIndex( ws2812bArray * const strip,
+                                                   const size_t pixelStartOffset,
+                                                   const size_t numPixelsToSet,
+                                                   const uint16_t bitmask,
+                                                   const uint8_t setIndex,
+                                                   const uint8_t clearIndex )
+{
+    if( ( NULL == strip ) ||
+        ( NULL == strip->pixelBuffer ) ||
+        ( numPixelsToSet > NUM_BITS_IN_BITMASK ) ||
+        ( pixelStartOffset + numPixelsToSet > strip->numPixels ) ||
+        ( setIndex >= WS2812B_PALETTE_SIZE ) ||
+        ( clearIndex >= WS2812B_PALETTE_SIZE ) )
+    {
+        return;
+    }
+
+    size_t i;
+    bool wasModified = false;
+    uint16_t thisBit = BITMASK_MSB;
+    for( i = pixelStartOffset; i < pixelStartOffset + numPixelsToSet; i++ )
+    {
+        wasModified |= WS2812b_WritePaletteIndex( strip->pixelBuffer,
+                                                  i,
+                                                  ( bitmask & thisBit ) ? setIndex : clearIndex );
+        thisBit >>= 1u;
+    }
+
+    if( wasModified )
+    {
+        WS2812b_MarkDirty( strip, pixelStartOffset, numPixelsToSet );
+    }
+    return;
+}
+
+void WS2812b_SetStripPaletteIndex( ws2812bArray * const strip,
+                                   const uint8_t paletteIndex )
+{
+    if( NULL == strip )
+    {
+        return;
+    }
+    WS2812b_SetPixelBlockPaletteIndex( strip,
+                                       0,
+                                       strip->numPixels,
+                                       paletteIndex );
+    return;
+}
+
+/* Function:
+ *      WS2812b_WritePaletteIndex
+ *
+ * Description:
+ *      Writes one pixel's index nibble, leaving the other pixel in the byte alone. Returns true if
+ *      the index changed. Callers have already range checked the pixel and the index.
+ */
+static bool WS2812b_WritePaletteIndex( ws2812bStorage * const buffer,
+                                       const size_t pixelIndex,
+                                       const uint8_t paletteIndex )
+{
+    ws2812bStorage * thisElement = &( buffer[WS2812B_STORAGE_INDEX( pixelIndex )] );
+    uint8_t updated;
+
+    if( 0u == ( pixelIndex & 1u ) )
+    {
+        updated = (uint8_t) ( ( *thisElement & PALETTE_INDEX_MASK ) | ( paletteIndex << PALETTE_HIGH_NIBBLE_SHIFT ) );
+    }
+    else
+    {
+        updated = (uint8_t) ( ( *thisElement & ~PALETTE_INDEX_MASK ) | paletteIndex );
+    }
+
+    if( updated == *thisElement )
+    {
+        return false;
+    }
+    *thisElement = updated;
+    return true;
+}
+
+#endif
+
+/* Function:
+ *      WS2812b_MarkDirty
+ *
+ * Description:
+ *      Records a modified block of pixels. Single buffered strips widen the dirty range. Double
+ *      buffered strips only widen the back buffer's range, since the front buffer doesn't change
+ *      until the next flip. Callers have already bounds checked the block.
+ */
+static void WS2812b_MarkDirty( ws2812bArray * const strip,
+                               const size_t startIndex,
+                               const size_t numPixels )
+{
+    if( 0u == numPixels )
+    {
+        return;
+    }
+
+    if( strip->pixelBuffer != strip->frontBuffer )
+    {
+        WS2812b_WidenRange( &( strip->backDirtyStartIndex ),
+                            &( strip->backDirtyEndIndex ),
+                            startIndex,
+                            numPixels );
+        return;
+    }
+
+    WS2812b_WidenRange( &( strip->dirtyStartIndex ),
+                        &( strip->dirtyEndIndex ),
+                        startIndex,
+                        numPixels );
+    return;
+}
+
+/* Function:
+ *      WS2812b_WidenRange
+ *
+ * Description:
+ *      Widens an end exclusive pixel range to include the given block. An empty range is replaced.
+ */
+static void WS2812b_WidenRange( size_t * const rangeStart,
+                                size_t * const rangeEnd,
+                                const size_t startIndex,
+                                const size_t numPixels )
+{
+    size_t endIndex = startIndex + numPixels;
+
+    if( *rangeStart == *rangeEnd )
+    {
+        *rangeStart = startIndex;
+        *rangeEnd = endIndex;
+        return;
+    }
+
+    if( startIndex < *rangeStart )
+    {
+        *rangeStart = startIndex;
+    }
+    if( endIndex > *rangeEnd )
+    {
+        *rangeEnd = endIndex;
+    }
     return;
 }
 
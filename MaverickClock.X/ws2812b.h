@@ -15,14 +15,24 @@
  *                      0 code = HIGH 400 ns , LOW 850 ns (All toleranced at += 150 ns)
  * Hardware section
  *      - WS2812B_Render
+ *      - WS2812B_RenderDirtyPrefix
+ *      - WS2812B_FlipBuffers
+ *      - WS2812B_SetBrightness
  *      - WS2812B_Reset
- *      - WS2812b_RenderSinglePixel
  *
- * Pixel Modification
+ * Pixel Modification (every function widens the strip's dirty range, RGB storage only)
  *      - WS2812b_SetPixelBlock
+ *      - WS2812b_SetPixelBlockFromBitmask
  *      - WS2812b_SetSinglePixelColor
  *      - WS2812b_ClearPixels
  *
+ * Palette Modification (palette storage only)
+ *      - WS2812b_SetPaletteColor
+ *      - WS2812b_SetSinglePixelPaletteIndex
+ *      - WS2812b_SetPixelBlockPaletteIndex
+ *      - WS2812b_SetPixelBlockFromBitmaskPaletteIndex
+ *      - WS2812b_SetStripPaletteIndex
+ *
  * API Requirements:
  *      1. Instruction frequency must operate at no less than 8 MHz (32 MHz clock speed). This
  *         driver is written using 8MHz (125 ns) instruction speed. The macros for WRITE_ONE and
@@ -65,10 +75,60 @@
 #define WS2812B_BLUE_INDEX 2u
 #define NUM_BYTES_IN_PIXEL 3u
 
+/* Global brightness levels: 0 is 1/8 brightness, each level doubles it */
+#define WS2812B_NUM_BRIGHTNESS_LEVELS 4u
+#define WS2812B_MAX_BRIGHTNESS_LEVEL ( WS2812B_NUM_BRIGHTNESS_LEVELS - 1u )
+
 #ifndef _XTAL_FREQ
 #define _XTAL_FREQ 32000000u
 #endif 
 
+/* Transport selection. Define WS2812B_TRANSPORT in the project settings to override.
+ *      WS2812B_TRANSPORT_BITBANG - NOP timed writes to DATA_PIN, interrupts off for the whole frame.
+ *      WS2812B_TRANSPORT_SPI     - MSSP1 streams 4 bit symbols out of SDO1 (routed to DATA_PIN),
+ *                                  interrupts are only off while a single pixel shifts out.
+ *      WS2812B_TRANSPORT_CLC     - CLC1 combines SCK1, SDO1, and PWM5 into the waveform, so the
+ *                                  CPU only feeds bytes. Interrupts are only off while the three
+ *                                  bytes of a single pixel are fed.
+ * The bit bang and SPI transports send the same codes and the same reset sequence. The CLC
+ * transport sends the same codes followed by a plain latch, see its WS2812B_Reset.
+ */
+#define WS2812B_TRANSPORT_BITBANG 0u
+#define WS2812B_TRANSPORT_SPI 1u
+#define WS2812B_TRANSPORT_CLC 2u
+
+#ifndef WS2812B_TRANSPORT
+#define WS2812B_TRANSPORT WS2812B_TRANSPORT_BITBANG
+#endif
+
+/* Pixel storage selection. Define WS2812B_STORAGE in the project settings to override.
+ *      WS2812B_STORAGE_RGB     - a full ws2812bPixel per pixel, any color anywhere.
+ *      WS2812B_STORAGE_PALETTE - a 4 bit index per pixel, two pixels per byte (the even pixel in
+ *                                the high nibble), into a WS2812B_PALETTE_SIZE entry palette held
+ *                                in the ws2812bArray. The transmit loop expands each index as it
+ *                                sends, so 64 pixels take 32 bytes plus the 48 byte palette
+ *                                instead of 192 bytes, and recoloring every pixel using an entry is
+ *                                a single palette write.
+ * Selected at build time like the transport, so the bit bang pixel lookup never tests the mode.
+ * The clock draws everything from a handful of colors, so the palette is the default.
+ */
+#define WS2812B_STORAGE_RGB 0u
+#define WS2812B_STORAGE_PALETTE 1u
+
+#ifndef WS2812B_STORAGE
+#define WS2812B_STORAGE WS2812B_STORAGE_PALETTE
+#endif
+
+#define WS2812B_PALETTE_SIZE 16u
+
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_PALETTE )
+#define WS2812B_STORAGE_SIZE(numPixels) ( ( ( numPixels ) + 1u ) / 2u ) // Buffer elements for numPixels pixels
+#elif ( WS2812B_STORAGE == WS2812B_STORAGE_RGB )
+#define WS2812B_STORAGE_SIZE(numPixels) ( numPixels )
+#else
+#error "WS2812B_STORAGE must be WS2812B_STORAGE_RGB or WS2812B_STORAGE_PALETTE"
+#endif
+
 
 /****************** Type Definition(s) *********************/
 
@@ -84,10 +144,48 @@ typedef struct
     uint8_t blue;
 } ws2812bPixel;
 
+/* Element of a pixel buffer. Size buffers with WS2812B_STORAGE_SIZE. */
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_PALETTE )
+typedef uint8_t ws2812bStorage; // Two palette indices
+#else
+typedef ws2812bPixel ws2812bStorage;
+#endif
+
+typedef enum
+{
+    WS2812B_FLIP_SWAP, // Flip only swaps, the caller recomposes the whole back buffer every frame
+    WS2812B_FLIP_COPY_DIRTY // Flip also copies the composed regions into the new back buffer
+} WS2812B_FLIP_MODE;
+
+/* pixelBuffer is the buffer every Set function composes into and frontBuffer is the buffer the
+ * render functions transmit. They are the same buffer unless the strip is double buffered, in
+ * which case WS2812B_FlipBuffers swaps them. backDirtyStartIndex and backDirtyEndIndex bound the
+ * pixels composed since the last flip.
+ *
+ * brightnessLevel selects the gamma and brightness lookup table row every byte passes through as
+ * it is sent. The buffers always hold uncorrected, full brightness colors.
+ *
+ * palette is only present with palette storage. Both buffers index the same palette, so a palette
+ * write shows on the next render without a flip.
+ *
+ * dirtyStartIndex and dirtyEndIndex bound the pixels modified since the last render, end
+ * exclusive. An empty range (start == end) means the strip already shows the pixel buffer, so the
+ * render functions skip the frame.
+ */
 typedef struct
 {
-    ws2812bPixel * pixelBuffer;
+    ws2812bStorage * pixelBuffer;
+    ws2812bStorage * frontBuffer;
     size_t numPixels;
+    size_t dirtyStartIndex;
+    size_t dirtyEndIndex;
+    WS2812B_FLIP_MODE flipMode;
+    size_t backDirtyStartIndex;
+    size_t backDirtyEndIndex;
+    uint8_t brightnessLevel;
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_PALETTE )
+    ws2812bPixel palette[WS2812B_PALETTE_SIZE];
+#endif
 } ws2812bArray;
 
 /********************* Function Prototype(s) ****************/
@@ -101,24 +199,94 @@ typedef struct
  *      Links a pixel buffer pointer and number of elements into a single ws2812bArray structure. In the future,
  *      this allows multiple LED strips to be defined in a single program. This can be implemented when a generic
  *      function parameter function pass to control the data pin is written (GPIO harmony module). 
+ *      The buffer holds WS2812B_STORAGE_SIZE(numElements) elements. With palette storage every
+ *      palette entry starts black.
  *
  * Return: 
  *      ws2812bArray structure with a pointer to the input pixel buffer and the number of elements.
  *
  */
-ws2812bArray WS2812b_Initialize(ws2812bPixel * pixelBuffer,
+ws2812bArray WS2812b_Initialize(ws2812bStorage * pixelBuffer,
         const size_t numElements,
         bool * const wasSetupSuccessful);
 
 
+/*
+ * Function: 
+ *      WS2812b_InitializeDoubleBuffered
+ *
+ * Description: 
+ *      Links a back buffer and a front buffer of numElements pixels into a double buffered
+ *      ws2812bArray. The Set functions compose into the back buffer, the render functions send the
+ *      front buffer, and WS2812B_FlipBuffers makes the composed frame the front buffer. A transmit
+ *      can therefore never send a half composed frame.
+ *
+ * Return: 
+ *      ws2812bArray structure. wasSetupSuccessful is false if either buffer is NULL or they are the
+ *      same buffer.
+ */
+ws2812bArray WS2812b_InitializeDoubleBuffered(ws2812bStorage * backBuffer,
+        ws2812bStorage * frontBuffer,
+        const size_t numElements,
+        const WS2812B_FLIP_MODE flipMode,
+        bool * const wasSetupSuccessful);
+
+
 /* Function: 
  *      WS2812B_Render
  *
  * Description: 
- *      Iteratively renders the contents of the strip's pixel buffer to the LEDs.
- *      This function takes 26 ms to render 64 pixels. This can be tremendously improved.. 
+ *      Iteratively renders the contents of the strip's pixel buffer to the LEDs through the selected
+ *      transport. The bit bang transport sends each byte through an unrolled, cycle balanced bit
+ *      sequence (1.125 us per bit), so 64 pixels take roughly 2 ms with interrupts disabled for the
+ *      entire frame. The SPI transport takes 1.5 us per bit and only disables interrupts per pixel.
+ *      The CLC transport takes 1.5 us per bit and leaves interrupts enabled.
+ *
+ *      Does nothing if the pixel buffer hasn't been modified since the last render, unless
+ *      forceRender is set. Force a render to refresh or recover a strip whose contents are unknown.
+ */
+void WS2812B_Render(ws2812bArray * const strip,
+        const bool forceRender);
+
+
+/* Function: 
+ *      WS2812B_RenderDirtyPrefix
+ *
+ * Description: 
+ *      Renders only pixels 0 up to and including the highest modified pixel, then latches. Pixels
+ *      past that keep their current colors, since the strip only updates the pixels it was sent.
+ *      Does nothing if no pixel has been modified since the last render.
+ */
+void WS2812B_RenderDirtyPrefix(ws2812bArray * const strip);
+
+
+/* Function:
+ *      WS2812B_SetBrightness
+ *
+ * Description:
+ *      Selects the global brightness level, 0 to WS2812B_MAX_BRIGHTNESS_LEVEL. Gamma correction
+ *      and brightness are applied by a lookup table as each byte is sent, so no buffer is rewritten.
+ *      The whole strip is marked for the next render.
  */
-void WS2812B_Render(const ws2812bArray * const strip);
+void WS2812B_SetBrightness(ws2812bArray * const strip,
+        const uint8_t brightnessLevel);
+
+
+/* Function:
+ *      WS2812B_FlipBuffers
+ *
+ * Description:
+ *      Double buffered strips only. Swaps the back and front buffers with interrupts disabled, so
+ *      the next render sends the frame composed since the last flip. In WS2812B_FLIP_COPY_DIRTY mode
+ *      the composed pixels are then copied into the new back buffer, so composing can continue
+ *      from the displayed frame, and a flip with nothing composed does nothing. In
+ *      WS2812B_FLIP_SWAP mode the new back buffer holds the frame before last and the caller must
+ *      recompose all of it.
+ */
+void WS2812B_FlipBuffers(ws2812bArray * const strip);
+
+
+#if ( WS2812B_STORAGE == WS2812B_STORAGE_RGB )
 
 
 /* Function: 
@@ -138,7 +306,8 @@ void WS2812b_SetSinglePixelColor(ws2812bArray * const strip,
  *      WS2812b_SetPixelBlockFromRGBArray
  *
  * Description: 
- *      Sets a block of pixels RGB values based on the input RGB byte array.
+ *      Sets a block of pixels RGB values based on the input RGB byte array. The array holds
+ *      numPixelsToSet pixels of NUM_BYTES_IN_PIXEL bytes each, red, green, blue.
  *
  * Parameter checks:
  *      1. NULL on all pointers.
@@ -146,7 +315,7 @@ void WS2812b_SetSinglePixelColor(ws2812bArray * const strip,
  *      3. The pixel start offset can't be larger than the number of pixels.
  *
  */
-void WS2812b_SetPixelBlockFromRGBArray(const ws2812bArray * const strip,
+void WS2812b_SetPixelBlockFromRGBArray(ws2812bArray * const strip,
         const size_t pixelStartOffset,
         const size_t numPixelsToSet,
         const uint8_t * const rgbArray);
@@ -159,7 +328,7 @@ void WS2812b_SetPixelBlockFromRGBArray(const ws2812bArray * const strip,
  * Description: 
  *      Sets a pixel block to a constant color input via RGB bytes.
  */
-void WS2812b_SetPixelBlockConstantColor(const ws2812bArray * const strip,
+void WS2812b_SetPixelBlockConstantColor(ws2812bArray * const strip,
         const size_t pixelStartOffset,
         const size_t numPixelsToSet,
         const uint8_t red,
@@ -167,6 +336,28 @@ void WS2812b_SetPixelBlockConstantColor(const ws2812bArray * const strip,
         const uint8_t blue);
 
 
+/*
+ * Function: 
+ *      WS2812b_SetPixelBlockFromBitmask
+ *
+ * Description: 
+ *      Expands a bitmask into a block of pixels, MSB first. Pixels whose bit is set are written
+ *      with setRGB, all others with clearRGB. Both color arrays are red, green, blue. Used to draw
+ *      glyphs straight into the pixel buffer without prerendered copies.
+ *
+ * Parameter checks:
+ *      1. NULL on all pointers.
+ *      2. numPixelsToSet can't be larger than the number of bits in the mask (16).
+ *      3. The block must fit inside the strip.
+ */
+void WS2812b_SetPixelBlockFromBitmask(ws2812bArray * const strip,
+        const size_t pixelStartOffset,
+        const size_t numPixelsToSet,
+        const uint16_t bitmask,
+        const uint8_t * const setRGB,
+        const uint8_t * const clearRGB);
+
+
 /*
  * Function:
  *      WS2812b_SetStripConstantColor()
@@ -191,10 +382,88 @@ void WS2812b_SetStripConstantColor(ws2812bArray * const strip,
  * 
  * Return: 
  */
-void WS2812b_CopyPixelBufferArrayFromSource(const ws2812bArray * const strip,
+void WS2812b_CopyPixelBufferArrayFromSource(ws2812bArray * const strip,
         ws2812bPixel * const pixelSource,
         const size_t startAddress,
         const size_t numPixelsToCopy);
 
+#else
+
+/*
+ * Function: 
+ *      WS2812b_SetPaletteColor
+ *
+ * Description: 
+ *      Sets a palette entry's RGB value. Every pixel using the entry changes color on the next
+ *      render, so the whole strip is marked for it. Rewriting the same color marks nothing.
+ */
+void WS2812b_SetPaletteColor(ws2812bArray * const strip,
+        const uint8_t paletteIndex,
+        const uint8_t red,
+        const uint8_t green,
+        const uint8_t blue);
+
+
+/*
+ * Function: 
+ *      WS2812b_SetSinglePixelPaletteIndex
+ *
+ * Description: 
+ *      Points a single pixel at a palette entry.
+ */
+void WS2812b_SetSinglePixelPaletteIndex(ws2812bArray * const strip,
+        const size_t pixelIndex,
+        const uint8_t paletteIndex);
+
+
+/*
+ * Function: 
+ *      WS2812b_SetPixelBlockPaletteIndex
+ *
+ * Description: 
+ *      Points a block of pixels at a single palette entry. The block is only marked if a pixel
+ *      changed.
+ */
+void WS2812b_SetPixelBlockPaletteIndex(ws2812bArray * const strip,
+        const size_t pixelStartOffset,
+        const size_t numPixelsToSet,
+        const uint8_t paletteIndex);
+
+
+/*
+ * Function: 
+ *      WS2812b_SetPixelBlockFromBitmaskPaletteIndex
+ *
+ * Description: 
+ *      Expands a bitmask into a block of palette indices, MSB first. Pixels whose bit is set point
+ *      at setIndex, all others at clearIndex. Used to draw glyphs, so that recoloring them later
+ *      is a palette write. The block is only marked if a pixel changed.
+ *
+ * Parameter checks:
+ *      1. numPixelsToSet can't be larger than the number of bits in the mask (16).
+ *      2. The block must fit inside the strip.
+ *      3. Both indices must be palette entries.
+ */
+void WS2812b_SetPixelBlockFromBitmaskPaletteIndex(ws2812bArray * const strip,
+        const size_t pixelStartOffset,
+        const size_t numPixelsToSet,
+        const uint16_t bitmask,
+        const uint8_t setIndex,
+        const uint8_t clearIndex);
+
+
+/*
+ * Function:
+ *      WS2812b_SetStripPaletteIndex
+ *
+ * Description: 
+ *      Points every pixel at a palette entry. Can call this function to clear the strip to a
+ *      single color.
+ */
+void WS2812b_SetStripPaletteIndex(ws2812bArray * const strip,
+        const uint8_t paletteIndex);
+
+#endif
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,223 @@
+#
+#  Checks the bit bang transport in an XC8 listing against the cycle budgets in ws2812b.c. The
+#  budget asserts in ws2812b.c only compare those constants with the datasheet, so this is the one
+#  check of the generated code. It is not part of the MPLAB build and has to be run by hand.
+#
+#     awk -f check_bitbang_listing.awk ../../MaverickClock.X/ws2812b.c <listing>.lst
+#
+#  ws2812b.c is read first for the byte gap budgets. In the listing, WS2812B_TransmitFrame must
+#  contain exactly 24 copies of the 9 instruction WRITE_BIT sequence documented in ws2812b.c, in
+#  three back to back blocks of 8. The instructions between the blocks are cycle counted and
+#  compared with the budgets. Counting is a static upper bound: every instruction in a gap is
+#  assumed to execute, branches and returns cost 2, and moviw/movwi or an INDF operand costs an
+#  extra cycle for a possible program memory access. A call inside a gap fails the check, since
+#  the callee's cycles are not counted.
+#
+#  The data pin operand is matched with the regular expression in pin, upper case with spaces
+#  removed. Override it with -v pin='...' if the listing spells LATC2 differently. The instruction
+#  time defaults to 125 ns (32 MHz), override it with -v ns_per_cycle=....
+#
+
+BEGIN {
+    if( pin == "" )
+    {
+        pin = "^(LATC|14|0X0E|0EH|\\(270\\)\\^0?80H|270),(2|LATC2)$"
+    }
+    split( "ADDWF ADDWFC ANDWF ASRF LSLF LSRF CLRF CLRW COMF DECF INCF IORWF MOVF MOVWF RLF RRF " \
+           "SUBWF SUBWFB SWAPF XORWF DECFSZ INCFSZ BCF BSF BTFSC BTFSS ADDLW ANDLW IORLW MOVLW " \
+           "SUBLW XORLW BRA BRW CALL CALLW GOTO RETFIE RETLW RETURN CLRWDT NOP OPTION RESET SLEEP " \
+           "TRIS ADDFSR MOVIW MOVWI MOVLB MOVLP", list, " " )
+    for( i in list )
+    {
+        isMnemonic[list[i]] = 1
+    }
+    split( "BRA BRW CALL CALLW GOTO RETFIE RETLW RETURN", list, " " )
+    for( i in list )
+    {
+        isTwoCycle[list[i]] = 1
+    }
+    if( ns_per_cycle == "" )
+    {
+        ns_per_cycle = 125
+    }
+    inFunction = 0
+    numInstructions = 0
+}
+
+# First file: the driver source, for the budgets.
+FNR == NR {
+    if( $1 == "#define" && $3 ~ /^[0-9]+u?$/ )
+    {
+        value = $3
+        sub( /u$/, "", value )
+        define[$2] = value + 0
+    }
+    next
+}
+
+# Second file: the listing. Only WS2812B_TransmitFrame is of interest.
+{
+    line = $0
+    sub( /;.*/, "", line )
+    if( match( line, /_[A-Za-z0-9_]+:/ ) )
+    {
+        label = substr( line, RSTART, RLENGTH - 1 )
+        inFunction = ( label ~ /WS2812B_TransmitFrame$/ )
+        next
+    }
+    if( !inFunction )
+    {
+        next
+    }
+    if( match( line, /(^|[ \t])[A-Za-z][A-Za-z0-9]*:/ ) )
+    {
+        localLabel = substr( line, RSTART, RLENGTH - 1 )
+        gsub( /[ \t]/, "", localLabel )
+        labelAt[toupper( localLabel )] = numInstructions + 1
+    }
+
+    numFields = split( line, field, /[ \t]+/ )
+    for( i = 1; i <= numFields; i++ )
+    {
+        mnemonic = toupper( field[i] )
+        if( mnemonic in isMnemonic )
+        {
+            operands = ""
+            for( j = i + 1; j <= numFields; j++ )
+            {
+                operands = operands field[j]
+            }
+            numInstructions++
+            op[numInstructions] = mnemonic
+            arg[numInstructions] = toupper( operands )
+            break
+        }
+    }
+}
+
+function isPin( n )
+{
+    return arg[n] ~ pin
+}
+
+function isWriteBit( n )
+{
+    return op[n] == "BSF" && isPin( n ) &&
+           op[n + 1] == "NOP" &&
+           op[n + 2] == "BTFSS" && !isPin( n + 2 ) &&
+           op[n + 3] == "BCF" && isPin( n + 3 ) &&
+           op[n + 4] == "NOP" && op[n + 5] == "NOP" &&
+           op[n + 6] == "BCF" && isPin( n + 6 ) &&
+           op[n + 7] == "NOP" && op[n + 8] == "NOP"
+}
+
+function cycles( n,    c, target )
+{
+    c = ( op[n] in isTwoCycle ) ? 2 : 1
+    target = arg[n]
+    sub( /,.*/, "", target )
+    if( op[n] == "MOVIW" || op[n] == "MOVWI" || target ~ /^(INDF[01]|0|1)$/ )
+    {
+        c++
+    }
+    if( op[n] == "CALL" || op[n] == "CALLW" )
+    {
+        print "error: call in a byte gap, callee cycles not counted: " op[n] " " arg[n]
+        failed = 1
+    }
+    return c
+}
+
+function gapCycles( first, last,    n, total )
+{
+    total = 0
+    for( n = first; n <= last; n++ )
+    {
+        total += cycles( n )
+    }
+    return total
+}
+
+function checkGap( name, measured, budget,    limit )
+{
+    # Longest gap that keeps a 0 code's low time under WS2812B_MAX_LOW_NS
+    limit = int( ( define["WS2812B_MAX_LOW_NS"] - 1 ) / ns_per_cycle ) - define["WRITE_ZERO_LOW_CYCLES"]
+    printf "%-22s %3d cycles, budget %3d, limit %3d\n", name, measured, budget, limit
+    if( measured > limit )
+    {
+        print "error: " name " stretches a low time past WS2812B_MAX_LOW_NS"
+        failed = 1
+    }
+    else if( measured > budget )
+    {
+        print "error: " name " exceeds its budget, raise the estimate in ws2812b.c"
+        failed = 1
+    }
+}
+
+END {
+    if( numInstructions == 0 )
+    {
+        print "error: WS2812B_TransmitFrame not found in the listing"
+        exit 1
+    }
+
+    numBits = 0
+    for( n = 1; n + 8 <= numInstructions; n++ )
+    {
+        if( isWriteBit( n ) )
+        {
+            numBits++
+            bitStart[numBits] = n
+            n += 8
+        }
+    }
+    printf "WRITE_BIT sequences   %3d, expected 24\n", numBits
+    if( numBits != 24 )
+    {
+        print "error: the bit loop does not match the documented WRITE_BIT listing"
+        exit 1
+    }
+
+    # Bits of a byte must follow each other with no instruction in between
+    for( b = 1; b <= 24; b++ )
+    {
+        if( ( b % 8 ) != 1 && bitStart[b] != bitStart[b - 1] + 9 )
+        {
+            print "error: instructions between bits " b - 1 " and " b
+            failed = 1
+        }
+    }
+
+    byteLoad = define["BYTE_BOUNDARY_OVERHEAD_CYCLES"] + define["GAMMA_LUT_LOOKUP_CYCLES"]
+    greenEnd = bitStart[8] + 8
+    redEnd = bitStart[16] + 8
+    blueEnd = bitStart[24] + 8
+
+    checkGap( "green to red gap", gapCycles( greenEnd + 1, bitStart[9] - 1 ), 2 * byteLoad )
+    checkGap( "red to blue gap", gapCycles( redEnd + 1, bitStart[17] - 1 ),
+              define["BYTE_BOUNDARY_OVERHEAD_CYCLES"] + define["PIXEL_BOUNDARY_OVERHEAD_CYCLES"] )
+
+    # The loop runs from the blue block through the branch back to the loop label, then on to the
+    # green block. If the branch back can't be found, everything before the green block is counted,
+    # setup included, which is only an upper bound.
+    loopEnd = 0
+    loopTop = 1
+    for( n = blueEnd + 1; n <= numInstructions; n++ )
+    {
+        if( ( op[n] == "GOTO" || op[n] == "BRA" ) && ( arg[n] in labelAt ) && labelAt[arg[n]] <= bitStart[1] )
+        {
+            loopEnd = n
+            loopTop = labelAt[arg[n]]
+        }
+    }
+    if( loopEnd == 0 )
+    {
+        print "warning: branch back to the pixel loop not found, counting from the function entry"
+        loopEnd = blueEnd
+    }
+    checkGap( "blue to green gap", gapCycles( blueEnd + 1, loopEnd ) + gapCycles( loopTop, bitStart[1] - 1 ),
+              define["PIXEL_LOOP_OVERHEAD_CYCLES"] + byteLoad )
+
+    exit failed
+}
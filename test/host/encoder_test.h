@@ -0,0 +1,97 @@
+/* Filename: encoder_test.h
+ *
+ * Description: Stand ins for the modules rotaryEncoder.c calls, and a model of the encoder pins,
+ *      shared by the encoder tests. TMR3 returns whatever the test set, and the pin change
+ *      interrupts are called directly. Include after rotaryEncoder.c.
+ *
+ */
+
+#ifndef ENCODER_TEST_H
+#define ENCODER_TEST_H
+
+#include "host_test.h"
+
+/****************** Macro Definition(s) *******************/
+#define ENCODER_CW 1
+#define ENCODER_CCW -1
+
+
+/****************** Local Variable(s) *********************/
+static volatile uint32_t testTimer3 = 0u; // Returned by TMR3_ReadExtendedTimer
+
+/* Pin states in clockwise order, (DT << 1) | CLK. Detents rest at index 0. */
+static const uint8_t encoderGrayCode[4] = {0x0u, 0x1u, 0x3u, 0x2u};
+static uint8_t encoderPhase = 0u;
+
+
+/*********************** Function(s) **********************/
+
+void IOCCF3_SetInterruptHandler( void (* InterruptHandler)( void ) )
+{
+    return;
+}
+
+void IOCCF4_SetInterruptHandler( void (* InterruptHandler)( void ) )
+{
+    return;
+}
+
+void IOCCF5_SetInterruptHandler( void (* InterruptHandler)( void ) )
+{
+    return;
+}
+
+uint32_t TMR3_ReadExtendedTimer( void )
+{
+    return testTimer3;
+}
+
+/* Function:
+ *      EncoderTest_SetPins
+ *
+ * Description:
+ *      Drives DT and CLK to the given (DT << 1) | CLK state and runs the shaft pin change ISR.
+ */
+static void EncoderTest_SetPins( const uint8_t pins )
+{
+    PORTCbits.RC4 = ( pins >> 1u ) & 0x1u;
+    PORTCbits.RC3 = pins & 0x1u;
+    RotaryEncoder_ReadShaftISR( );
+    return;
+}
+
+/* Function:
+ *      EncoderTest_QuarterStep
+ *
+ * Description:
+ *      Turns the shaft one quadrature state in the given direction, one pin change.
+ *
+ * Return:
+ *      True if the shaft arrived at a detent.
+ */
+static bool EncoderTest_QuarterStep( const int direction )
+{
+    encoderPhase = (uint8_t) ( encoderPhase + direction ) & 0x3u;
+    EncoderTest_SetPins( encoderGrayCode[encoderPhase] );
+    return 0u == encoderPhase;
+}
+
+/* Function:
+ *      EncoderTest_Reset
+ *
+ * Description:
+ *      Links and enables the given encoder with the shaft resting at a detent.
+ */
+static void EncoderTest_Reset( RotaryEncoder * const encoder )
+{
+    encoderPhase = 0u;
+    PORTCbits.RC3 = 0u;
+    PORTCbits.RC4 = 0u;
+    CHECK( RotaryEncoder_Init( encoder ) );
+    RotaryEncoder_Enable( );
+    return;
+}
+
+#endif
+
+/* End encoder_test.h header file */
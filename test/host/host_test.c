@@ -0,0 +1,18 @@
+/* Filename: host_test.c
+ *
+ * Description: Check counters shared by the host tests.
+ *
+ */
+
+#include "host_test.h"
+
+unsigned long hostTestChecks = 0u;
+unsigned long hostTestFailures = 0u;
+
+int HostTest_Finish( const char * testName )
+{
+    printf( "%s: %lu checks, %lu failed\n", testName, hostTestChecks, hostTestFailures );
+    return ( 0u == hostTestFailures ) ? 0 : 1;
+}
+
+/* End host_test.c source file */
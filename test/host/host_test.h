@@ -0,0 +1,53 @@
+/* Filename: host_test.h
+ *
+ * Description: Minimal check macros shared by the host tests. A failed check prints its location
+ *      and is counted. HostTest_Finish prints the summary and returns the process exit code.
+ *
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+extern unsigned long hostTestChecks;
+extern unsigned long hostTestFailures;
+
+#define CHECK(cond) \
+    do { \
+        hostTestChecks++; \
+        if( !( cond ) ) \
+        { \
+            hostTestFailures++; \
+            fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); \
+        } \
+    } while( 0 )
+
+#define CHECK_EQUAL(actual, expected) \
+    do { \
+        long long actualValue_ = (long long) ( actual ); \
+        long long expectedValue_ = (long long) ( expected ); \
+        hostTestChecks++; \
+        if( actualValue_ != expectedValue_ ) \
+        { \
+            hostTestFailures++; \
+            fprintf( stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, \
+                     actualValue_, expectedValue_ ); \
+        } \
+    } while( 0 )
+
+/* Function:
+ *      HostTest_Finish
+ *
+ * Description:
+ *      Prints the pass/fail summary for the named test.
+ *
+ * Return:
+ *      0 if every check passed, 1 otherwise.
+ */
+int HostTest_Finish( const char * testName );
+
+#endif
+
+/* End host_test.h header file */
@@ -0,0 +1,70 @@
+/* Filename: sim.c
+ *
+ * Description: Simulated instruction cycle clock, see sim.h.
+ *
+ */
+
+#include "sim.h"
+
+/****************** Local Variable(s) *********************/
+unsigned long simCycles = 0u;
+static unsigned long maskedSinceCycles = 0u;
+static unsigned long longestMaskedCycles = 0u;
+
+
+/****************** Static Function Prototype(s) **********/
+static void Sim_Delay( unsigned long us );
+
+
+/*********************** Function(s) **********************/
+
+void Sim_Reset( void )
+{
+    simCycles = 0u;
+    maskedSinceCycles = 0u;
+    longestMaskedCycles = 0u;
+    INTCONbits.GIE = 1;
+    INTCONbits.PEIE = 1;
+    Host_DelayHook = Sim_Delay;
+    return;
+}
+
+void Sim_GlobalInterruptDisable( void )
+{
+    if( INTCONbits.GIE )
+    {
+        maskedSinceCycles = simCycles;
+    }
+    INTCONbits.GIE = 0;
+    return;
+}
+
+void Sim_GlobalInterruptEnable( void )
+{
+    if( ( !INTCONbits.GIE ) &&
+        ( simCycles - maskedSinceCycles > longestMaskedCycles ) )
+    {
+        longestMaskedCycles = simCycles - maskedSinceCycles;
+    }
+    INTCONbits.GIE = 1;
+    return;
+}
+
+unsigned long Sim_GetLongestMaskedCycles( void )
+{
+    return longestMaskedCycles;
+}
+
+/* Function:
+ *      Sim_Delay
+ *
+ * Description:
+ *      __delay_us hook, a busy wait of whole instruction cycles.
+ */
+static void Sim_Delay( unsigned long us )
+{
+    simCycles += us * 1000ul / SIM_NS_PER_CYCLE;
+    return;
+}
+
+/* End sim.c source file */
@@ -0,0 +1,57 @@
+/* Filename: sim.h
+ *
+ * Description: Simulated instruction cycle clock for the transport tests. The test's primitives
+ *      advance simCycles, __delay_us advances it through the xc.h delay hook, and the interrupt
+ *      manager macros below time every window with global interrupts masked.
+ *
+ *      Include before a firmware source in place of mcc_generated_files/interrupt_manager.h. The
+ *      include guard of that header is defined here, so the firmware's own include is skipped.
+ *
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <xc.h>
+#include <stdbool.h>
+
+/****************** Macro Definition(s) *******************/
+#define SIM_NS_PER_CYCLE 125ul // 32 MHz, 4 clocks per instruction
+#define SIM_CYCLES_TO_NS(cycles) ( (unsigned long) ( cycles ) * SIM_NS_PER_CYCLE )
+
+#define INTERRUPT_MANAGER_H
+#define INTERRUPT_GlobalInterruptEnable() Sim_GlobalInterruptEnable( )
+#define INTERRUPT_GlobalInterruptDisable() Sim_GlobalInterruptDisable( )
+#define INTERRUPT_PeripheralInterruptEnable() ( INTCONbits.PEIE = 1 )
+#define INTERRUPT_PeripheralInterruptDisable() ( INTCONbits.PEIE = 0 )
+
+
+/****************** Variable(s) ***************************/
+extern unsigned long simCycles;
+
+
+/****************** Function Prototype(s) *****************/
+
+/* Function:
+ *      Sim_Reset
+ *
+ * Description:
+ *      Restarts the clock at 0 with interrupts enabled, clears the masked window statistics, and
+ *      installs the delay hook.
+ */
+void Sim_Reset( void );
+
+void Sim_GlobalInterruptEnable( void );
+void Sim_GlobalInterruptDisable( void );
+
+/* Function:
+ *      Sim_GetLongestMaskedCycles
+ *
+ * Description:
+ *      Longest time between a global interrupt disable and the following enable since Sim_Reset.
+ */
+unsigned long Sim_GetLongestMaskedCycles( void );
+
+#endif
+
+/* End sim.h header file */
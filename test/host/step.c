@@ -0,0 +1,87 @@
+/* Filename: step.c
+ *
+ * Description: Instruction single stepping for the race tests, see step.h.
+ *
+ */
+
+#define _GNU_SOURCE
+#include "step.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#if ( STEP_IS_SUPPORTED == 1 )
+#include <signal.h>
+#include <string.h>
+#include <ucontext.h>
+
+/****************** Macro Definition(s) *******************/
+#define EFLAGS_TRAP 0x100ll
+
+
+/****************** Local Variable(s) *********************/
+static void (* volatile stepHook)( unsigned long step ) = NULL;
+static volatile unsigned long stepCount = 0u;
+static volatile bool isStepping = false;
+static bool isHandlerInstalled = false;
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      Step_TrapHandler
+ *
+ * Description:
+ *      Runs after every stepped instruction. The kernel clears the trap flag for the handler, so
+ *      the hook is not stepped, and the flag is set again in the saved context on the way back.
+ */
+static void Step_TrapHandler( int signal,
+                              siginfo_t * info,
+                              void * context )
+{
+    ucontext_t * userContext = context;
+    if( !isStepping )
+    {
+        userContext->uc_mcontext.gregs[REG_EFL] &= ~EFLAGS_TRAP;
+        return;
+    }
+    stepCount++;
+    stepHook( stepCount );
+    userContext->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TRAP;
+    return;
+}
+
+unsigned long Step_Run( void (* body)( void ),
+                        void (* hook)( unsigned long step ) )
+{
+    if( !isHandlerInstalled )
+    {
+        struct sigaction action;
+        memset( &action, 0, sizeof (action ) );
+        action.sa_sigaction = Step_TrapHandler;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset( &action.sa_mask );
+        sigaction( SIGTRAP, &action, NULL );
+        isHandlerInstalled = true;
+    }
+
+    stepHook = hook;
+    stepCount = 0u;
+    isStepping = true;
+    __asm__ volatile ( "pushfq\n\torq $0x100, (%%rsp)\n\tpopfq" ::: "memory", "cc" );
+    body( );
+    isStepping = false; // The next trap clears the flag
+    return stepCount;
+}
+
+#else
+
+unsigned long Step_Run( void (* body)( void ),
+                        void (* hook)( unsigned long step ) )
+{
+    body( );
+    return 0u;
+}
+
+#endif
+
+/* End step.c source file */
@@ -0,0 +1,39 @@
+/* Filename: step.h
+ *
+ * Description: Single steps host code one machine instruction at a time and calls a hook at every
+ *      instruction boundary, so a test can run an ISR between any two instructions of the main
+ *      loop code it races with. Uses the x86-64 trap flag and a SIGTRAP handler. On other hosts
+ *      STEP_IS_SUPPORTED is 0 and nothing is stepped.
+ *
+ */
+
+#ifndef STEP_H
+#define STEP_H
+
+/****************** Macro Definition(s) *******************/
+#if defined( __x86_64__ ) && defined( __linux__ )
+#define STEP_IS_SUPPORTED 1
+#else
+#define STEP_IS_SUPPORTED 0
+#endif
+
+
+/****************** Function Prototype(s) *****************/
+
+/* Function:
+ *      Step_Run
+ *
+ * Description:
+ *      Calls body with the trap flag set. After each instruction, hook is called with the number
+ *      of instructions run so far. The hook runs with stepping off, as an ISR would, and it runs
+ *      for a few instructions of Step_Run itself either side of body.
+ *
+ * Return:
+ *      The number of instructions stepped, 0 if stepping is not supported. body still runs.
+ */
+unsigned long Step_Run( void (* body)( void ),
+                        void (* hook)( unsigned long step ) );
+
+#endif
+
+/* End step.h header file */
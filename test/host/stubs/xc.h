@@ -0,0 +1,153 @@
+/* Filename: xc.h
+ *
+ * Description: Host stand in for the XC8 device header. Declares just the special function
+ *      registers the firmware modules under test touch, as plain variables in stubs/xc_host.c,
+ *      and maps the compiler builtins to host functions. A test that needs to observe a register
+ *      access defines the register name as a macro before including any firmware source, which
+ *      suppresses the declaration below.
+ *
+ */
+
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#include <stdint.h>
+
+/****************** Compiler Builtin(s) *******************/
+#define NOP() ( (void) 0 )
+#define CLRWDT() ( (void) 0 )
+#define SLEEP() ( (void) 0 )
+#define __delay_us(us) Host_DelayUs( (unsigned long) ( us ) )
+#define __delay_ms(ms) Host_DelayUs( (unsigned long) ( ms ) * 1000ul )
+#define __interrupt(...)
+#define __pack
+#define __at(address)
+#define __EEPROM_DATA(...)
+
+/* Called for every __delay_us/__delay_ms. Tests that keep simulated time set a hook. */
+extern void (*Host_DelayHook)( unsigned long us );
+void Host_DelayUs( unsigned long us );
+
+
+/****************** Bit Field Register(s) *****************/
+typedef struct
+{
+    unsigned GIE : 1;
+    unsigned PEIE : 1;
+} INTCONbits_t;
+
+typedef struct
+{
+    unsigned LATC2 : 1;
+} LATCbits_t;
+
+typedef struct
+{
+    unsigned RC2 : 1;
+    unsigned RC3 : 1;
+    unsigned RC4 : 1;
+    unsigned RC5 : 1;
+} PORTCbits_t;
+
+typedef struct
+{
+    unsigned TMR3IE : 1;
+} PIE3bits_t;
+
+typedef struct
+{
+    unsigned TMR3IF : 1;
+} PIR3bits_t;
+
+typedef struct
+{
+    unsigned TMR5IE : 1;
+} PIE4bits_t;
+
+typedef struct
+{
+    unsigned TMR5IF : 1;
+} PIR4bits_t;
+
+typedef struct
+{
+    unsigned TMR3ON : 1;
+    unsigned T3SYNC : 1;
+} T3CONbits_t;
+
+typedef struct
+{
+    unsigned TMR5ON : 1;
+    unsigned T5SYNC : 1;
+} T5CONbits_t;
+
+typedef struct
+{
+    unsigned T3GGO_nDONE : 1;
+    unsigned T3GVAL : 1;
+} T3GCONbits_t;
+
+typedef struct
+{
+    unsigned T5GGO_nDONE : 1;
+    unsigned T5GVAL : 1;
+} T5GCONbits_t;
+
+typedef struct
+{
+    unsigned BF : 1;
+} SSP1STATbits_t;
+
+extern volatile INTCONbits_t INTCONbits;
+extern volatile LATCbits_t LATCbits;
+extern volatile PORTCbits_t PORTCbits;
+extern volatile PIE3bits_t PIE3bits;
+extern volatile PIR3bits_t PIR3bits;
+extern volatile PIE4bits_t PIE4bits;
+extern volatile PIR4bits_t PIR4bits;
+extern volatile T3CONbits_t T3CONbits;
+extern volatile T5CONbits_t T5CONbits;
+extern volatile T3GCONbits_t T3GCONbits;
+extern volatile T5GCONbits_t T5GCONbits;
+#ifndef SSP1STATbits
+extern volatile SSP1STATbits_t SSP1STATbits;
+#endif
+
+
+/****************** Byte Register(s) **********************/
+extern volatile uint8_t TMR3H;
+extern volatile uint8_t TMR3L;
+extern volatile uint8_t T3CON;
+extern volatile uint8_t T3GCON;
+extern volatile uint8_t TMR5H;
+extern volatile uint8_t TMR5L;
+extern volatile uint8_t T5CON;
+extern volatile uint8_t T5GCON;
+
+extern volatile uint8_t SSP1BUF;
+extern volatile uint8_t SSP1STAT;
+extern volatile uint8_t SSP1ADD;
+extern volatile uint8_t SSP1CON1;
+extern volatile uint8_t RC2PPS;
+
+extern volatile uint8_t T2CON;
+extern volatile uint8_t TMR2;
+extern volatile uint8_t PR2;
+extern volatile uint8_t CCPTMRS;
+extern volatile uint8_t PWM5DCH;
+extern volatile uint8_t PWM5DCL;
+extern volatile uint8_t PWM5CON;
+extern volatile uint8_t CLC1CON;
+extern volatile uint8_t CLC1SEL0;
+extern volatile uint8_t CLC1SEL1;
+extern volatile uint8_t CLC1SEL2;
+extern volatile uint8_t CLC1SEL3;
+extern volatile uint8_t CLC1GLS0;
+extern volatile uint8_t CLC1GLS1;
+extern volatile uint8_t CLC1GLS2;
+extern volatile uint8_t CLC1GLS3;
+extern volatile uint8_t CLC1POL;
+
+#endif
+
+/* End xc.h stub */
@@ -0,0 +1,67 @@
+/* Filename: xc_host.c
+ *
+ * Description: Storage for the registers declared in the host xc.h stub, and the delay hook.
+ *
+ */
+
+#include <xc.h>
+#include <stddef.h>
+
+void (*Host_DelayHook)( unsigned long us ) = NULL;
+
+void Host_DelayUs( unsigned long us )
+{
+    if( NULL != Host_DelayHook )
+    {
+        Host_DelayHook( us );
+    }
+    return;
+}
+
+volatile INTCONbits_t INTCONbits;
+volatile LATCbits_t LATCbits;
+volatile PORTCbits_t PORTCbits;
+volatile PIE3bits_t PIE3bits;
+volatile PIR3bits_t PIR3bits;
+volatile PIE4bits_t PIE4bits;
+volatile PIR4bits_t PIR4bits;
+volatile T3CONbits_t T3CONbits;
+volatile T5CONbits_t T5CONbits;
+volatile T3GCONbits_t T3GCONbits;
+volatile T5GCONbits_t T5GCONbits;
+volatile SSP1STATbits_t SSP1STATbits;
+
+volatile uint8_t TMR3H;
+volatile uint8_t TMR3L;
+volatile uint8_t T3CON;
+volatile uint8_t T3GCON;
+volatile uint8_t TMR5H;
+volatile uint8_t TMR5L;
+volatile uint8_t T5CON;
+volatile uint8_t T5GCON;
+
+volatile uint8_t SSP1BUF;
+volatile uint8_t SSP1STAT;
+volatile uint8_t SSP1ADD;
+volatile uint8_t SSP1CON1;
+volatile uint8_t RC2PPS;
+
+volatile uint8_t T2CON;
+volatile uint8_t TMR2;
+volatile uint8_t PR2;
+volatile uint8_t CCPTMRS;
+volatile uint8_t PWM5DCH;
+volatile uint8_t PWM5DCL;
+volatile uint8_t PWM5CON;
+volatile uint8_t CLC1CON;
+volatile uint8_t CLC1SEL0;
+volatile uint8_t CLC1SEL1;
+volatile uint8_t CLC1SEL2;
+volatile uint8_t CLC1SEL3;
+volatile uint8_t CLC1GLS0;
+volatile uint8_t CLC1GLS1;
+volatile uint8_t CLC1GLS2;
+volatile uint8_t CLC1GLS3;
+volatile uint8_t CLC1POL;
+
+/* End xc_host.c source file */
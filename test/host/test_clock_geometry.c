@@ -0,0 +1,179 @@
+/* Filename: test_clock_geometry.c
+ *
+ * Description: Host test of the face geometry tables in clockLEDs.c, built on the real ws2812b.c
+ *      with the bit bang pin writes stubbed out.
+ *
+ *      Every pixel must sit in exactly one cell of the grid, and the pixel to cell and cell to
+ *      pixel lookups must undo each other. Each column returned must match the cells read one at a
+ *      time. Lookups past the last pixel or off the face must return CLOCK_NO_PIXEL or NULL rather
+ *      than read past the tables. Prints the face as the tables describe it, so the wiring can be
+ *      checked by eye against the board.
+ *
+ */
+
+/****************** Counting Primitive(s) *****************/
+#define WS2812B_TRANSPORT WS2812B_TRANSPORT_BITBANG
+#define WS2812B_PIN_HIGH()
+#define WS2812B_PIN_LOW()
+#define WS2812B_PIN_LOW_IF_CLEAR(byte, mask) (void) ( byte );
+#define WS2812B_CYCLE()
+
+#include "ws2812b.c"
+#include "prng.c"
+#include "clockLEDs.c"
+#include "host_test.h"
+#include <stdio.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define NUM_WIRED_CELLS_EXPECTED NUM_CLOCK_PIXELS
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      CheckEveryPixelPlacedOnce
+ *
+ * Description:
+ *      Walks every cell of the face. Each pixel index must turn up exactly once, and the cell it
+ *      turns up in must be the one Clock_GetPixelX and Clock_GetPixelY give for it.
+ */
+static void CheckEveryPixelPlacedOnce( void )
+{
+    uint8_t timesSeen[NUM_CLOCK_PIXELS] = {0u};
+    unsigned numWiredCells = 0u;
+    uint8_t x;
+    uint8_t y;
+    uint8_t pixel;
+
+    for( x = 0u; x < CLOCK_FACE_WIDTH; x++ )
+    {
+        for( y = 0u; y < CLOCK_FACE_HEIGHT; y++ )
+        {
+            pixel = Clock_GetPixelAt( x, y );
+            if( CLOCK_NO_PIXEL == pixel )
+            {
+                continue;
+            }
+            CHECK( pixel < NUM_CLOCK_PIXELS );
+            if( pixel < NUM_CLOCK_PIXELS )
+            {
+                timesSeen[pixel]++;
+                CHECK_EQUAL( Clock_GetPixelX( pixel ), x );
+                CHECK_EQUAL( Clock_GetPixelY( pixel ), y );
+            }
+            numWiredCells++;
+        }
+    }
+
+    CHECK_EQUAL( numWiredCells, NUM_WIRED_CELLS_EXPECTED );
+    for( pixel = 0u; pixel < NUM_CLOCK_PIXELS; pixel++ )
+    {
+        CHECK_EQUAL( timesSeen[pixel], 1u );
+        CHECK_EQUAL( Clock_GetPixelAt( Clock_GetPixelX( pixel ), Clock_GetPixelY( pixel ) ), pixel );
+    }
+    return;
+}
+
+/* Function:
+ *      CheckColumns
+ *
+ * Description:
+ *      Each column Clock_GetColumnPixels returns must read the same as Clock_GetPixelAt, top to
+ *      bottom.
+ */
+static void CheckColumns( void )
+{
+    uint8_t x;
+    uint8_t y;
+
+    for( x = 0u; x < CLOCK_FACE_WIDTH; x++ )
+    {
+        const uint8_t * column = Clock_GetColumnPixels( x );
+        CHECK( NULL != column );
+        if( NULL == column )
+        {
+            continue;
+        }
+        for( y = 0u; y < CLOCK_FACE_HEIGHT; y++ )
+        {
+            CHECK_EQUAL( column[y], Clock_GetPixelAt( x, y ) );
+        }
+    }
+    return;
+}
+
+/* Function:
+ *      CheckOutOfRange
+ *
+ * Description:
+ *      Every index past the last pixel, and every column or row off the face, up to the largest a
+ *      uint8_t can hold.
+ */
+static void CheckOutOfRange( void )
+{
+    unsigned i;
+
+    for( i = NUM_CLOCK_PIXELS; i <= 0xFFu; i++ )
+    {
+        CHECK_EQUAL( Clock_GetPixelX( (uint8_t) i ), CLOCK_NO_PIXEL );
+        CHECK_EQUAL( Clock_GetPixelY( (uint8_t) i ), CLOCK_NO_PIXEL );
+    }
+    for( i = CLOCK_FACE_WIDTH; i <= 0xFFu; i++ )
+    {
+        CHECK( NULL == Clock_GetColumnPixels( (uint8_t) i ) );
+        CHECK_EQUAL( Clock_GetPixelAt( (uint8_t) i, 0u ), CLOCK_NO_PIXEL );
+    }
+    for( i = CLOCK_FACE_HEIGHT; i <= 0xFFu; i++ )
+    {
+        CHECK_EQUAL( Clock_GetPixelAt( 0u, (uint8_t) i ), CLOCK_NO_PIXEL );
+    }
+    return;
+}
+
+/* Function:
+ *      PrintFace
+ *
+ * Description:
+ *      The face as the tables describe it, one pixel index per wired cell, dots for empty cells.
+ */
+static void PrintFace( void )
+{
+    uint8_t x;
+    uint8_t y;
+
+    for( y = 0u; y < CLOCK_FACE_HEIGHT; y++ )
+    {
+        printf( "   " );
+        for( x = 0u; x < CLOCK_FACE_WIDTH; x++ )
+        {
+            uint8_t pixel = Clock_GetPixelAt( x, y );
+            if( CLOCK_NO_PIXEL == pixel )
+            {
+                printf( "  ." );
+            }
+            else
+            {
+                printf( " %2u", pixel );
+            }
+        }
+        printf( "\n" );
+    }
+    return;
+}
+
+int main( void )
+{
+    CheckEveryPixelPlacedOnce( );
+    CheckColumns( );
+    CheckOutOfRange( );
+
+    printf( "face geometry, %u x %u cells\n", CLOCK_FACE_WIDTH, CLOCK_FACE_HEIGHT );
+    printf( "  tables                : %u bytes of flash\n",
+            (unsigned) ( sizeof (pixelPositions ) + sizeof (faceColumns ) ) );
+    PrintFace( );
+
+    return HostTest_Finish( "test_clock_geometry" );
+}
+
+/* End test_clock_geometry.c source file */
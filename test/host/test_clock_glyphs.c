@@ -0,0 +1,653 @@
+/* Filename: test_clock_glyphs.c
+ *
+ * Description: Host test and benchmark of the digit glyph engine in clockLEDs.c, built on the real
+ *      ws2812b.c with palette storage and the bit bang pin writes replaced by a counter of
+ *      transmitted codes.
+ *
+ *      Runs every minute of a day through Clock_WriteTimeDigitValuesAndRenderScreen and checks
+ *      the transmitted buffer, expanded through the palette, against a from scratch expansion of
+ *      the four glyphs each time, so the changed digit tracking, the dirty copy on flip, and the
+ *      dirty prefix render are covered together. Every glyph is also forced at every position. A
+ *      color change must only write the palette, leave both index buffers alone, and resend the
+ *      whole face in the new colors.
+ *
+ *      The digit path it replaced, prerendered RGB caches copied into an RGB render buffer with a
+ *      fix up for digit 4, is kept below as it was in the baseline clockLEDs.c. Both paths are
+ *      single stepped through the same day of minute changes and a color change, and must produce
+ *      the same pixels. memcpy and memcmp are byte loops here, as XC8's are, so a vectorized
+ *      library copy doesn't flatter either path. Prints host instructions per minute change and
+ *      per color change for each path, and the RAM of the real buffers by sizeof.
+ *
+ */
+
+/****************** Counting Primitive(s) *****************/
+#include <string.h>
+
+static unsigned long codesSent = 0u;
+
+static void * Bench_ByteCopy( void * dest,
+                              const void * src,
+                              size_t n );
+static int Bench_ByteCompare( const void * a,
+                              const void * b,
+                              size_t n );
+
+#define WS2812B_TRANSPORT WS2812B_TRANSPORT_BITBANG
+#define WS2812B_PIN_HIGH() ( codesSent++ )
+#define WS2812B_PIN_LOW()
+#define WS2812B_PIN_LOW_IF_CLEAR(byte, mask) (void) ( byte );
+#define WS2812B_CYCLE()
+#define memcpy(dest, src, n) Bench_ByteCopy( ( dest ), ( src ), ( n ) )
+#define memcmp(a, b, n) Bench_ByteCompare( ( a ), ( b ), ( n ) )
+
+#include "ws2812b.c"
+#include "prng.c"
+#include "clockLEDs.c"
+#include "host_test.h"
+#include "step.h"
+#include <stdio.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define NUM_DIGIT_POSITIONS 4u
+#define NUM_RESET_CODES 3u // The bit bang reset sends a 1 and a 0 code before and a 1 code after the latch
+#define MINUTES_PER_DAY ( 24u * 60u )
+
+/* Distinct colors, so a swapped byte or a digit pixel left in background shows up */
+#define DIGIT_RED 0x11u
+#define DIGIT_GREEN 0x22u
+#define DIGIT_BLUE 0x33u
+#define BACKGROUND_RED 0x44u
+#define BACKGROUND_GREEN 0x55u
+#define BACKGROUND_BLUE 0x66u
+
+/* The color change benchmark swaps the two */
+#define NEW_DIGIT_RED BACKGROUND_RED
+#define NEW_DIGIT_GREEN BACKGROUND_GREEN
+#define NEW_DIGIT_BLUE BACKGROUND_BLUE
+#define NEW_BACKGROUND_RED DIGIT_RED
+#define NEW_BACKGROUND_GREEN DIGIT_GREEN
+#define NEW_BACKGROUND_BLUE DIGIT_BLUE
+
+/* Baseline digit 4 fix up, see Legacy_FixDigit4LastThreePixels */
+#define LEGACY_DIGIT4_COPY_PIXELS ( NUM_PIXELS_PER_DIGIT - 4u )
+#define LEGACY_DIGIT4_FIX_ADDRESS 61u
+#define LEGACY_NUM_PIXELS_TO_FIX_DIGIT4 3u
+
+
+/****************** Local Variable(s) *********************/
+static const size_t digitStarts[NUM_DIGIT_POSITIONS] = {1u, 16u, 36u, 51u};
+static const size_t digitSizes[NUM_DIGIT_POSITIONS] = {NUM_PIXELS_PER_DIGIT, NUM_PIXELS_PER_DIGIT,
+                                                         NUM_PIXELS_PER_DIGIT, NUM_PIXELS_DIGIT_4};
+
+/* The baseline's prerendered caches, single render buffer, and colors, declared as it declared them */
+static ws2812bPixel legacyUpCache[TOTAL_NUM_DIGITS][NUM_PIXELS_PER_DIGIT]; // Digits 1 and 4
+static ws2812bPixel legacyDownCache[TOTAL_NUM_DIGITS][NUM_PIXELS_PER_DIGIT]; // Digits 2 and 3
+static ws2812bPixel legacyBuffer[NUM_CLOCK_PIXELS];
+static uint8_t currentDIGITrgbArray[NUM_BYTES_IN_PIXEL] = {DIGIT_RED, DIGIT_GREEN, DIGIT_BLUE};
+static uint8_t currentBACKGROUNDrgbArray[NUM_BYTES_IN_PIXEL] = {BACKGROUND_RED, BACKGROUND_GREEN, BACKGROUND_BLUE};
+
+/* Digits the benchmark bodies write, and which of them changed */
+static uint8_t benchValues[NUM_DIGIT_POSITIONS];
+static bool isBenchChanged[NUM_DIGIT_POSITIONS];
+
+
+/*********************** Function(s) **********************/
+
+static void * Bench_ByteCopy( void * dest,
+                              const void * src,
+                              size_t n )
+{
+    volatile uint8_t * d = dest;
+    const volatile uint8_t * s = src;
+    while( n-- > 0u )
+    {
+        *d++ = *s++;
+    }
+    return dest;
+}
+
+static int Bench_ByteCompare( const void * a,
+                              const void * b,
+                              size_t n )
+{
+    const volatile uint8_t * x = a;
+    const volatile uint8_t * y = b;
+    for( ; n > 0u; n--, x++, y++ )
+    {
+        if( *x != *y )
+        {
+            return ( *x < *y ) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static void NoHook( unsigned long step )
+{
+    return;
+}
+
+/* Function:
+ *      ExpectedGlyph
+ *
+ * Description:
+ *      The encoding a digit position uses for a value.
+ */
+static uint16_t ExpectedGlyph( const uint8_t position,
+                               const uint8_t value )
+{
+    switch( position )
+    {
+        case 0u:
+            return upDigitEncodings[value];
+        case 1u:
+        case 2u:
+            return downDigitEncodings[value];
+        default:
+            return digit4Encodings[value];
+    }
+}
+
+/* Function:
+ *      CheckPixels
+ *
+ * Description:
+ *      Expands the four glyphs from scratch and compares every pixel of a buffer. Pixels outside
+ *      the digits must hold the background.
+ */
+static void CheckPixels( const ws2812bPixel * const buffer,
+                         const uint8_t * const values,
+                         const uint8_t * const digitRGB,
+                         const uint8_t * const backgroundRGB )
+{
+    bool isDigitPixel[NUM_CLOCK_PIXELS] = {false};
+    uint8_t position;
+    size_t i;
+
+    for( position = 0u; position < NUM_DIGIT_POSITIONS; position++ )
+    {
+        uint16_t glyph = ExpectedGlyph( position, values[position] );
+        for( i = 0u; i < digitSizes[position]; i++ )
+        {
+            isDigitPixel[digitStarts[position] + i] = 0u != ( glyph & ( 0x8000u >> i ) );
+        }
+    }
+
+    for( i = 0u; i < NUM_CLOCK_PIXELS; i++ )
+    {
+        const uint8_t * expected = isDigitPixel[i] ? digitRGB : backgroundRGB;
+        CHECK_EQUAL( buffer[i].red, expected[WS2812B_RED_INDEX] );
+        CHECK_EQUAL( buffer[i].green, expected[WS2812B_GREEN_INDEX] );
+        CHECK_EQUAL( buffer[i].blue, expected[WS2812B_BLUE_INDEX] );
+    }
+    return;
+}
+
+/* Function:
+ *      ExpandIndices
+ *
+ * Description:
+ *      Looks every pixel of one of the strip's index buffers up in its palette, the even pixel of
+ *      each byte from the high nibble. Returns the expanded buffer, which is overwritten by the
+ *      next call.
+ */
+static const ws2812bPixel * ExpandIndices( const ws2812bStorage * const indices )
+{
+    static ws2812bPixel expanded[NUM_CLOCK_PIXELS];
+    size_t i;
+
+    for( i = 0u; i < NUM_CLOCK_PIXELS; i++ )
+    {
+        uint8_t packed = indices[i / 2u];
+        expanded[i] = ledArray.palette[( 0u == ( i % 2u ) ) ? ( packed >> 4u ) : ( packed & 0x0Fu )];
+    }
+    return expanded;
+}
+
+/* Function:
+ *      CheckFrame
+ *
+ * Description:
+ *      The buffer the strip was last sent must show the digits in the test colors.
+ */
+static void CheckFrame( const TimeInDigits * const digits )
+{
+    const uint8_t values[NUM_DIGIT_POSITIONS] = {digits->digit1, digits->digit2, digits->digit3, digits->digit4};
+    const uint8_t digitRGB[NUM_BYTES_IN_PIXEL] = {DIGIT_RED, DIGIT_GREEN, DIGIT_BLUE};
+    const uint8_t backgroundRGB[NUM_BYTES_IN_PIXEL] = {BACKGROUND_RED, BACKGROUND_GREEN, BACKGROUND_BLUE};
+    CheckPixels( ExpandIndices( ledArray.frontBuffer ), values, digitRGB, backgroundRGB );
+    return;
+}
+
+/* Function:
+ *      CheckEncodings
+ *
+ * Description:
+ *      Digit positions must not overlap or run off the strip, the bits past a glyph's last pixel
+ *      must be clear, and no two values of a position may share a glyph.
+ */
+static void CheckEncodings( void )
+{
+    uint8_t position;
+    uint8_t value;
+    uint8_t other;
+
+    for( position = 0u; position < NUM_DIGIT_POSITIONS; position++ )
+    {
+        CHECK( digitStarts[position] + digitSizes[position] <= NUM_CLOCK_PIXELS );
+        if( position > 0u )
+        {
+            CHECK( digitStarts[position - 1u] + digitSizes[position - 1u] <= digitStarts[position] );
+        }
+        for( value = 0u; value < TOTAL_NUM_DIGITS; value++ )
+        {
+            uint16_t glyph = ExpectedGlyph( position, value );
+            CHECK_EQUAL( glyph & ( 0xFFFFu >> digitSizes[position] ), 0u );
+            for( other = 0u; other < value; other++ )
+            {
+                CHECK( glyph != ExpectedGlyph( position, other ) );
+            }
+        }
+    }
+    CHECK_EQUAL( digit1StartPixel, digitStarts[0] );
+    CHECK_EQUAL( digit2StartPixel, digitStarts[1] );
+    CHECK_EQUAL( digit3StartPixel, digitStarts[2] );
+    CHECK_EQUAL( digit4StartPixel, digitStarts[3] );
+    return;
+}
+
+/****************** Legacy Cache Path *********************/
+/* The baseline digit path. Clock_PrerenderPixelAndBackgroundValues expanded every glyph into the
+ * caches, and a digit change copied its cached pixels into the render buffer. Digit 4 copied 10
+ * pixels from the up cache and fixed its last three up by hand. */
+
+/* Function:
+ *      Legacy_ExpandCache
+ *
+ * Description:
+ *      The baseline Clock_WriteDigitPixelValuesToLocalPxlBuffers.
+ */
+static void Legacy_ExpandCache( ws2812bPixel * const pixelBuffer,
+                                const uint16_t * encodingSource )
+{
+    size_t digitCounter;
+    size_t encodingCounter;
+    uint8_t * thisDigitStartAddress = &( pixelBuffer->red );
+    for( digitCounter = 0; digitCounter < TOTAL_NUM_DIGITS; digitCounter++ )
+    {
+        for( encodingCounter = 0; encodingCounter < NUM_PIXELS_PER_DIGIT; encodingCounter++ )
+        {
+            if( ( *encodingSource << encodingCounter ) & 0x8000u )
+            {
+                memcpy( thisDigitStartAddress, currentDIGITrgbArray, NUM_BYTES_IN_PIXEL );
+            }
+            else
+            {
+                memcpy( thisDigitStartAddress, currentBACKGROUNDrgbArray, NUM_BYTES_IN_PIXEL );
+            }
+            thisDigitStartAddress += NUM_BYTES_IN_PIXEL;
+        }
+        encodingSource++;
+    }
+    return;
+}
+
+/* Function:
+ *      Legacy_Prerender
+ *
+ * Description:
+ *      The baseline Clock_PrerenderPixelAndBackgroundValues: the background, then both caches.
+ */
+static void Legacy_Prerender( void )
+{
+    size_t i;
+    for( i = 0u; i < NUM_CLOCK_PIXELS; i++ )
+    {
+        legacyBuffer[i].red = currentBACKGROUNDrgbArray[WS2812B_RED_INDEX];
+        legacyBuffer[i].green = currentBACKGROUNDrgbArray[WS2812B_GREEN_INDEX];
+        legacyBuffer[i].blue = currentBACKGROUNDrgbArray[WS2812B_BLUE_INDEX];
+    }
+    Legacy_ExpandCache( legacyUpCache[0], upDigitEncodings );
+    Legacy_ExpandCache( legacyDownCache[0], downDigitEncodings );
+    return;
+}
+
+/* Function:
+ *      Legacy_CopyFromCache
+ *
+ * Description:
+ *      The baseline WS2812b_CopyPixelBufferArrayFromSource, a plain copy.
+ */
+static void Legacy_CopyFromCache( const ws2812bPixel * const source,
+                                  const size_t startAddress,
+                                  const size_t numPixelsToCopy )
+{
+    memcpy( &( legacyBuffer[startAddress].red ), &( source->red ), numPixelsToCopy * NUM_BYTES_IN_PIXEL );
+    return;
+}
+
+static void Legacy_SetPixel( const size_t pixel,
+                             const uint8_t * const rgb )
+{
+    legacyBuffer[pixel].red = rgb[WS2812B_RED_INDEX];
+    legacyBuffer[pixel].green = rgb[WS2812B_GREEN_INDEX];
+    legacyBuffer[pixel].blue = rgb[WS2812B_BLUE_INDEX];
+    return;
+}
+
+/* Function:
+ *      Legacy_FixDigit4LastThreePixels
+ *
+ * Description:
+ *      The baseline fix up: pixels 61-63 to background, then the digit pixels by value.
+ */
+static void Legacy_FixDigit4LastThreePixels( const uint8_t digit4Value )
+{
+    size_t i;
+    for( i = 0u; i < LEGACY_NUM_PIXELS_TO_FIX_DIGIT4; i++ )
+    {
+        Legacy_SetPixel( LEGACY_DIGIT4_FIX_ADDRESS + i, currentBACKGROUNDrgbArray );
+    }
+
+    if( ( 0u == digit4Value ) ||
+        ( 1u == digit4Value ) ||
+        ( 3u == digit4Value ) ||
+        ( 8u == digit4Value ) )
+    {
+        Legacy_SetPixel( 61u, currentDIGITrgbArray );
+        Legacy_SetPixel( 63u, currentDIGITrgbArray );
+    }
+    else if( ( 2u == digit4Value ) ||
+             ( 7u == digit4Value ) ||
+             ( 9u == digit4Value ) ||
+             ( 4u == digit4Value ) )
+    {
+        Legacy_SetPixel( 63u, currentDIGITrgbArray );
+    }
+    else if( ( 5u == digit4Value ) ||
+             ( 6u == digit4Value ) )
+    {
+        Legacy_SetPixel( 61u, currentDIGITrgbArray );
+    }
+    return;
+}
+
+/* Function:
+ *      Legacy_WriteChangedDigits
+ *
+ * Description:
+ *      Benchmark body. The digit writes of the baseline Clock_WriteTimeDigitValuesAndRenderScreen.
+ */
+static void Legacy_WriteChangedDigits( void )
+{
+    if( isBenchChanged[0] )
+    {
+        Legacy_CopyFromCache( legacyUpCache[benchValues[0]], digit1StartPixel, NUM_PIXELS_PER_DIGIT );
+    }
+    if( isBenchChanged[1] )
+    {
+        Legacy_CopyFromCache( legacyDownCache[benchValues[1]], digit2StartPixel, NUM_PIXELS_PER_DIGIT );
+    }
+    if( isBenchChanged[2] )
+    {
+        Legacy_CopyFromCache( legacyDownCache[benchValues[2]], digit3StartPixel, NUM_PIXELS_PER_DIGIT );
+    }
+    if( isBenchChanged[3] )
+    {
+        Legacy_CopyFromCache( legacyUpCache[benchValues[3]], digit4StartPixel, LEGACY_DIGIT4_COPY_PIXELS );
+        Legacy_FixDigit4LastThreePixels( benchValues[3] );
+    }
+    return;
+}
+
+/* Function:
+ *      Legacy_ColorChange
+ *
+ * Description:
+ *      Benchmark body. The baseline color change: both colors, the background and caches
+ *      prerendered again, then every digit copied back in.
+ */
+static void Legacy_ColorChange( void )
+{
+    currentDIGITrgbArray[WS2812B_RED_INDEX] = NEW_DIGIT_RED;
+    currentDIGITrgbArray[WS2812B_GREEN_INDEX] = NEW_DIGIT_GREEN;
+    currentDIGITrgbArray[WS2812B_BLUE_INDEX] = NEW_DIGIT_BLUE;
+    currentBACKGROUNDrgbArray[WS2812B_RED_INDEX] = NEW_BACKGROUND_RED;
+    currentBACKGROUNDrgbArray[WS2812B_GREEN_INDEX] = NEW_BACKGROUND_GREEN;
+    currentBACKGROUNDrgbArray[WS2812B_BLUE_INDEX] = NEW_BACKGROUND_BLUE;
+    Legacy_Prerender( );
+    isBenchChanged[0] = true;
+    isBenchChanged[1] = true;
+    isBenchChanged[2] = true;
+    isBenchChanged[3] = true;
+    Legacy_WriteChangedDigits( );
+    return;
+}
+
+/****************** Palette Glyph Path ********************/
+
+/* Function:
+ *      Glyph_WriteChangedDigits
+ *
+ * Description:
+ *      Benchmark body. The digit writes of Clock_WriteTimeDigitValuesAndRenderScreen, without the
+ *      flip and render the legacy path is not charged for either. Each changed digit's glyph is
+ *      expanded into palette indices.
+ */
+static void Glyph_WriteChangedDigits( void )
+{
+    if( isBenchChanged[0] )
+    {
+        Clock_WriteDigitGlyph( digit1StartPixel, NUM_PIXELS_PER_DIGIT, upDigitEncodings[benchValues[0]] );
+    }
+    if( isBenchChanged[1] )
+    {
+        Clock_WriteDigitGlyph( digit2StartPixel, NUM_PIXELS_PER_DIGIT, downDigitEncodings[benchValues[1]] );
+    }
+    if( isBenchChanged[2] )
+    {
+        Clock_WriteDigitGlyph( digit3StartPixel, NUM_PIXELS_PER_DIGIT, downDigitEncodings[benchValues[2]] );
+    }
+    if( isBenchChanged[3] )
+    {
+        Clock_WriteDigitGlyph( digit4StartPixel, NUM_PIXELS_DIGIT_4, digit4Encodings[benchValues[3]] );
+    }
+    return;
+}
+
+/* Function:
+ *      Glyph_ColorChange
+ *
+ * Description:
+ *      Benchmark body. A color change is the two palette writes, no pixel is touched.
+ */
+static void Glyph_ColorChange( void )
+{
+    Clock_SetDigitRGBArray( NEW_DIGIT_RED, NEW_DIGIT_GREEN, NEW_DIGIT_BLUE );
+    Clock_SetBackgroundRGBArray( NEW_BACKGROUND_RED, NEW_BACKGROUND_GREEN, NEW_BACKGROUND_BLUE );
+    return;
+}
+
+/* Function:
+ *      BenchmarkMinuteChanges
+ *
+ * Description:
+ *      Steps both paths through a day of minute changes from a common start. Each must leave the
+ *      same pixels in its render buffer. Returns the host instructions each took in total.
+ */
+static void BenchmarkMinuteChanges( unsigned long * const legacyInstructions,
+                                    unsigned long * const glyphInstructions )
+{
+    const uint8_t digitRGB[NUM_BYTES_IN_PIXEL] = {DIGIT_RED, DIGIT_GREEN, DIGIT_BLUE};
+    const uint8_t backgroundRGB[NUM_BYTES_IN_PIXEL] = {BACKGROUND_RED, BACKGROUND_GREEN, BACKGROUND_BLUE};
+    uint8_t lastValues[NUM_DIGIT_POSITIONS] = {0xFFu, 0xFFu, 0xFFu, 0xFFu};
+    uint16_t minute;
+    uint8_t position;
+
+    *legacyInstructions = 0u;
+    *glyphInstructions = 0u;
+    Legacy_Prerender( );
+    for( minute = 0u; minute <= MINUTES_PER_DAY; minute++ )
+    {
+        uint16_t wrapped = minute % MINUTES_PER_DAY;
+        benchValues[0] = (uint8_t) ( wrapped / 600u );
+        benchValues[1] = (uint8_t) ( ( wrapped / 60u ) % 10u );
+        benchValues[2] = (uint8_t) ( ( wrapped % 60u ) / 10u );
+        benchValues[3] = (uint8_t) ( wrapped % 10u );
+        for( position = 0u; position < NUM_DIGIT_POSITIONS; position++ )
+        {
+            isBenchChanged[position] = benchValues[position] != lastValues[position];
+            lastValues[position] = benchValues[position];
+        }
+
+        *legacyInstructions += Step_Run( Legacy_WriteChangedDigits, NoHook );
+        *glyphInstructions += Step_Run( Glyph_WriteChangedDigits, NoHook );
+        CheckPixels( legacyBuffer, benchValues, digitRGB, backgroundRGB );
+        CheckPixels( ExpandIndices( ledArray.pixelBuffer ), benchValues, digitRGB, backgroundRGB );
+    }
+    return;
+}
+
+/* Function:
+ *      BenchmarkColorChange
+ *
+ * Description:
+ *      Steps both paths through a change of both colors. Each must show the new colors. The
+ *      palette path must not touch either index buffer, and its next render must send the whole
+ *      face in the new colors. Returns the index buffer bytes the palette path rewrote.
+ */
+static unsigned BenchmarkColorChange( unsigned long * const legacyInstructions,
+                                      unsigned long * const glyphInstructions )
+{
+    const uint8_t digitRGB[NUM_BYTES_IN_PIXEL] = {NEW_DIGIT_RED, NEW_DIGIT_GREEN, NEW_DIGIT_BLUE};
+    const uint8_t backgroundRGB[NUM_BYTES_IN_PIXEL] = {NEW_BACKGROUND_RED, NEW_BACKGROUND_GREEN, NEW_BACKGROUND_BLUE};
+    const TimeInDigits digits = {benchValues[0], benchValues[1], benchValues[2], benchValues[3]};
+    uint8_t backBefore[sizeof (renderBuffer )];
+    uint8_t frontBefore[sizeof (displayBuffer )];
+    unsigned numBytesRewritten = 0u;
+    size_t i;
+
+    /* Bring the front buffer level with the benchmark's last frame, then snapshot both */
+    Clock_WriteTimeDigitValuesAndRenderScreen( &digits );
+    memcpy( backBefore, renderBuffer, sizeof (renderBuffer ) );
+    memcpy( frontBefore, displayBuffer, sizeof (displayBuffer ) );
+
+    *legacyInstructions = Step_Run( Legacy_ColorChange, NoHook );
+    *glyphInstructions = Step_Run( Glyph_ColorChange, NoHook );
+    CheckPixels( legacyBuffer, benchValues, digitRGB, backgroundRGB );
+
+    for( i = 0u; i < sizeof (renderBuffer ); i++ )
+    {
+        numBytesRewritten += ( backBefore[i] != renderBuffer[i] ) ? 1u : 0u;
+        numBytesRewritten += ( frontBefore[i] != displayBuffer[i] ) ? 1u : 0u;
+    }
+    CHECK_EQUAL( numBytesRewritten, 0u );
+    CHECK_EQUAL( ledArray.dirtyStartIndex, 0u );
+    CHECK_EQUAL( ledArray.dirtyEndIndex, NUM_CLOCK_PIXELS );
+
+    codesSent = 0u;
+    WS2812B_RenderDirtyPrefix( &ledArray );
+    CHECK_EQUAL( codesSent, NUM_CLOCK_PIXELS * NUM_BYTES_IN_PIXEL * 8u + NUM_RESET_CODES );
+    CheckPixels( ExpandIndices( ledArray.frontBuffer ), benchValues, digitRGB, backgroundRGB );
+    return numBytesRewritten;
+}
+
+int main( void )
+{
+    TimeInDigits digits;
+    uint16_t minute;
+    uint8_t value;
+    unsigned long digitsWritten = 0u;
+    unsigned long pixelsSent = 0u;
+    uint8_t lastValues[NUM_DIGIT_POSITIONS] = {0xFFu, 0xFFu, 0xFFu, 0xFFu};
+
+    CheckEncodings( );
+    CHECK( Clock_InitializeClockLEDs( NUM_CLOCK_PIXELS,
+                                      DIGIT_RED, DIGIT_GREEN, DIGIT_BLUE,
+                                      BACKGROUND_RED, BACKGROUND_GREEN, BACKGROUND_BLUE ) );
+    Clock_PrerenderPixelAndBackgroundValues( );
+
+    /* Every glyph at every position */
+    for( value = 0u; value < TOTAL_NUM_DIGITS; value++ )
+    {
+        digits.digit1 = value;
+        digits.digit2 = value;
+        digits.digit3 = value;
+        digits.digit4 = value;
+        Clock_ForceRender( &digits );
+        CheckFrame( &digits );
+    }
+
+    /* A day of minute changes, then midnight again. Only the changed digits may be rewritten, and
+     * only up to the last of them sent. */
+    for( minute = 0u; minute <= MINUTES_PER_DAY; minute++ )
+    {
+        uint16_t wrapped = minute % MINUTES_PER_DAY;
+        digits.digit1 = (uint8_t) ( wrapped / 600u );
+        digits.digit2 = (uint8_t) ( ( wrapped / 60u ) % 10u );
+        digits.digit3 = (uint8_t) ( ( wrapped % 60u ) / 10u );
+        digits.digit4 = (uint8_t) ( wrapped % 10u );
+
+        const uint8_t values[NUM_DIGIT_POSITIONS] = {digits.digit1, digits.digit2, digits.digit3, digits.digit4};
+        size_t lastChangedEnd = 0u;
+        uint8_t position;
+        for( position = 0u; position < NUM_DIGIT_POSITIONS; position++ )
+        {
+            if( values[position] != lastValues[position] )
+            {
+                lastValues[position] = values[position];
+                lastChangedEnd = digitStarts[position] + digitSizes[position];
+                digitsWritten++;
+            }
+        }
+
+        codesSent = 0u;
+        Clock_WriteTimeDigitValuesAndRenderScreen( &digits );
+        CheckFrame( &digits );
+        CHECK_EQUAL( codesSent, lastChangedEnd * NUM_BYTES_IN_PIXEL * 8u + NUM_RESET_CODES );
+        pixelsSent += lastChangedEnd;
+    }
+
+    unsigned long numChanges = MINUTES_PER_DAY + 1u;
+
+    /* Digit 4 ends the chain and changes every minute, so the dirty prefix is always the whole
+     * strip on this face, as clockLEDs.c says */
+    CHECK_EQUAL( pixelsSent, numChanges * NUM_CLOCK_PIXELS );
+
+    /* The render buffer now holds the last frame, the legacy path starts from the same */
+    unsigned long legacyMinuteInstructions;
+    unsigned long glyphMinuteInstructions;
+    unsigned long legacyColorInstructions;
+    unsigned long glyphColorInstructions;
+    BenchmarkMinuteChanges( &legacyMinuteInstructions, &glyphMinuteInstructions );
+    unsigned colorChangeBytes = BenchmarkColorChange( &legacyColorInstructions, &glyphColorInstructions );
+
+    printf( "glyph expansion, %lu minute changes\n", numChanges );
+    printf( "  digit caches          : %u bytes of RAM before, none after\n",
+            (unsigned) ( sizeof (legacyUpCache ) + sizeof (legacyDownCache ) ) );
+    printf( "  render buffers        : %u bytes of RAM for back and front indices plus a %u byte palette, %u for the baseline's single RGB buffer\n",
+            (unsigned) ( sizeof (renderBuffer ) + sizeof (displayBuffer ) ), (unsigned) sizeof (ledArray.palette ),
+            (unsigned) sizeof (legacyBuffer ) );
+    printf( "  glyph flash           : %u bytes of encodings\n",
+            (unsigned) ( sizeof (upDigitEncodings ) + sizeof (downDigitEncodings ) + sizeof (digit4Encodings ) ) );
+    printf( "  color change rewrites : %u index bytes, then all %u pixels sent\n", colorChangeBytes, NUM_CLOCK_PIXELS );
+    printf( "  per minute change     : %lu.%02lu digits expanded, %lu.%02lu pixels sent\n",
+            digitsWritten / numChanges, ( digitsWritten * 100u / numChanges ) % 100u,
+            pixelsSent / numChanges, ( pixelsSent * 100u / numChanges ) % 100u );
+    if( STEP_IS_SUPPORTED )
+    {
+        printf( "  digit writes          : %lu host instructions per minute change from the caches, %lu expanded\n",
+                legacyMinuteInstructions / numChanges, glyphMinuteInstructions / numChanges );
+        printf( "  color change          : %lu host instructions from the caches, %lu as palette writes\n",
+                legacyColorInstructions, glyphColorInstructions );
+    }
+    else
+    {
+        printf( "  instruction counts    : single stepping needs an x86-64 Linux host, skipped\n" );
+    }
+
+    return HostTest_Finish( "test_clock_glyphs" );
+}
+
+/* End test_clock_glyphs.c source file */
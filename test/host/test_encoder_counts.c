@@ -0,0 +1,183 @@
+/* Filename: test_encoder_counts.c
+ *
+ * Description: Host fuzz test of the shaft detent handoff in rotaryEncoder.c. The main loop's
+ *      RotaryEncoder_GetShaftCounts is single stepped, and the shaft pin change ISR is run after
+ *      every one of its instructions, with the shaft turning in a random walk that reverses
+ *      mid-detent. Every detent the ISR counts must be returned by exactly one poll.
+ *
+ *      Run with acceleration off, where the polls must add up to the physical detents turned, and
+ *      on, where they must add up to the steps the ISR added to its counter. A long fast spin
+ *      between two polls must come back whole in either direction.
+ *
+ */
+
+#include "rotaryEncoder.c"
+#include "encoder_test.h"
+#include "step.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define NUM_POLLS 10000u
+#define REVERSE_ONE_IN 8u // Chance per quarter step that the walk turns back
+#define MAX_QUARTER_STEP_CTS 40u // TMR3 counts per quarter step, slow enough to reach every curve entry
+#define NUM_FAST_SPIN_DETENTS 1000u // Well past the 16 detents that wrapped a byte wide counter at the largest step
+
+
+/****************** Local Variable(s) *********************/
+static RotaryEncoder plainEncoder = {
+    .shaft.config.isAccelerationEnabled = false
+};
+
+static RotaryEncoder acceleratedEncoder = {
+    .shaft.config.isAccelerationEnabled = true
+};
+
+static uint32_t randomState = 12345u;
+static int walkDirection = ENCODER_CW;
+static long shaftQuarterSteps = 0; // Physical position of the shaft
+static long isrCounts = 0; // Sum of every step the ISR added to its counter
+static int32_t polledCounts = 0;
+static unsigned long numIsrCalls = 0u;
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      NextRandom
+ *
+ * Description:
+ *      Small deterministic LCG, so every run walks the same way.
+ */
+static uint32_t NextRandom( const uint32_t range )
+{
+    randomState = randomState * 1664525u + 1013904223u;
+    return ( randomState >> 8u ) % range;
+}
+
+/* Function:
+ *      TurnShaft
+ *
+ * Description:
+ *      Step hook. Moves the shaft one quadrature state along the random walk and records what the
+ *      ISR did to its counter.
+ */
+static void TurnShaft( unsigned long step )
+{
+    if( 0u == NextRandom( REVERSE_ONE_IN ) )
+    {
+        walkDirection = -walkDirection;
+    }
+    testTimer3 += 1u + NextRandom( MAX_QUARTER_STEP_CTS );
+
+    uint16_t countsBefore = rot->shaft.counts;
+    (void) EncoderTest_QuarterStep( walkDirection );
+    isrCounts += (int16_t) ( rot->shaft.counts - countsBefore );
+    shaftQuarterSteps += walkDirection;
+    numIsrCalls++;
+    return;
+}
+
+static void PollBody( void )
+{
+    polledCounts += RotaryEncoder_GetShaftCounts( );
+    return;
+}
+
+/* Function:
+ *      RunFuzz
+ *
+ * Description:
+ *      Polls NUM_POLLS times with a quarter step after every instruction of each poll, brings the
+ *      shaft back to a detent, and polls once more. Returns the largest count a single poll saw.
+ */
+static long RunFuzz( RotaryEncoder * const encoder )
+{
+    unsigned long poll;
+    long largestPoll = 0;
+
+    EncoderTest_Reset( encoder );
+    shaftQuarterSteps = 0;
+    isrCounts = 0;
+    polledCounts = 0;
+
+    for( poll = 0u; poll < NUM_POLLS; poll++ )
+    {
+        int32_t before = polledCounts;
+        (void) Step_Run( PollBody, TurnShaft );
+
+        /* What was not returned yet must still be waiting in the counter */
+        CHECK_EQUAL( polledCounts + (int16_t) ( rot->shaft.counts - rot->shaft.lastSeenCounts ), isrCounts );
+        if( labs( (long) ( polledCounts - before ) ) > largestPoll )
+        {
+            largestPoll = labs( (long) ( polledCounts - before ) );
+        }
+    }
+
+    while( 0u != encoderPhase )
+    {
+        TurnShaft( 0u );
+    }
+    PollBody( );
+    CHECK_EQUAL( polledCounts, isrCounts );
+    CHECK_EQUAL( RotaryEncoder_GetShaftCounts( ), 0 );
+    return largestPoll;
+}
+
+/* Function:
+ *      CheckFastSpin
+ *
+ * Description:
+ *      Spins NUM_FAST_SPIN_DETENTS detents each way at the largest acceleration step with no poll in
+ *      between. Each poll must return the whole spin.
+ */
+static void CheckFastSpin( void )
+{
+    int direction;
+    unsigned long quarterStep;
+
+    EncoderTest_Reset( &acceleratedEncoder );
+    for( direction = ENCODER_CCW; direction <= ENCODER_CW; direction += 2 )
+    {
+        for( quarterStep = 0u; quarterStep < NUM_FAST_SPIN_DETENTS * 4u; quarterStep++ )
+        {
+            testTimer3 += 1u;
+            (void) EncoderTest_QuarterStep( direction );
+        }
+        CHECK_EQUAL( RotaryEncoder_GetShaftCounts( ), direction * (int32_t) ( NUM_FAST_SPIN_DETENTS * accelerationCurve[0] ) );
+    }
+    return;
+}
+
+int main( void )
+{
+    CheckFastSpin( );
+
+    if( !STEP_IS_SUPPORTED )
+    {
+        printf( "encoder counts: single stepping needs an x86-64 Linux host, skipped\n" );
+        return HostTest_Finish( "test_encoder_counts" );
+    }
+
+    long largestPlainPoll = RunFuzz( &plainEncoder );
+    CHECK_EQUAL( shaftQuarterSteps % 4, 0 );
+    CHECK_EQUAL( polledCounts, shaftQuarterSteps / 4 );
+    CHECK( 0 != polledCounts );
+    long plainDetents = polledCounts;
+    unsigned long plainIsrCalls = numIsrCalls;
+
+    numIsrCalls = 0u;
+    long largestAcceleratedPoll = RunFuzz( &acceleratedEncoder );
+    CHECK( labs( (long) polledCounts ) > labs( shaftQuarterSteps / 4 ) );
+
+    printf( "shaft count handoff, a quarter step after every instruction of %u polls\n", NUM_POLLS );
+    printf( "  plain                 : %lu ISR calls, %+ld detents net, up to %ld per poll\n",
+            plainIsrCalls, plainDetents, largestPlainPoll );
+    printf( "  accelerated           : %lu ISR calls, %+ld counts net, up to %ld per poll\n",
+            numIsrCalls, (long) polledCounts, largestAcceleratedPoll );
+
+    return HostTest_Finish( "test_encoder_counts" );
+}
+
+/* End test_encoder_counts.c source file */
@@ -0,0 +1,200 @@
+/* Filename: test_encoder_quadrature.c
+ *
+ * Description: Host test of the quadrature table decoder in rotaryEncoder.c, built with
+ *      ROT_ENC_COUNTS_PER_DETENT at its default. test_encoder_quadrature_x2.c and _x4.c build it
+ *      with the other two settings.
+ *
+ *      Every entry of the table is checked against a direction worked out from the Gray code
+ *      order, so a mistyped entry shows up. The ISR is then driven through whole detents both
+ *      ways, detents that turn back halfway, contact bounce on either pin, and transitions where
+ *      both pins changed. It must count ROT_ENC_COUNTS_PER_DETENT per detent of rotation, leave
+ *      nothing counted for a bounce or a turn back once the shaft is home, and count every skipped
+ *      state as invalid.
+ *
+ */
+
+#include "rotaryEncoder.c"
+#include "encoder_test.h"
+#include <stdio.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define NUM_PIN_STATES 4u
+#define NUM_TEST_DETENTS 25u
+#define NUM_BOUNCES 10u
+
+
+/****************** Local Variable(s) *********************/
+static RotaryEncoder encoder = {
+    .shaft.config.isAccelerationEnabled = false
+};
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      GrayPhase
+ *
+ * Description:
+ *      Position of a (DT << 1) | CLK pin state in the clockwise Gray code order.
+ */
+static uint8_t GrayPhase( const uint8_t pins )
+{
+    uint8_t phase;
+    for( phase = 0u; phase < NUM_PIN_STATES; phase++ )
+    {
+        if( encoderGrayCode[phase] == pins )
+        {
+            break;
+        }
+    }
+    return phase;
+}
+
+/* Function:
+ *      CheckTable
+ *
+ * Description:
+ *      Each (last, current) entry must be +1 one state clockwise, -1 one state counterclockwise, 0
+ *      for no change, and invalid two states away. The documented clockwise and counterclockwise
+ *      vector orders must decode as such.
+ */
+static void CheckTable( void )
+{
+    const uint8_t cwOrder[4] = {1u, 7u, 14u, 8u};
+    const uint8_t ccwOrder[4] = {2u, 11u, 13u, 4u};
+    uint8_t vector;
+    uint8_t i;
+
+    for( vector = 0u; vector < 16u; vector++ )
+    {
+        uint8_t steps = (uint8_t) ( GrayPhase( vector & 0x3u ) - GrayPhase( vector >> 2u ) ) & 0x3u;
+        int8_t expected = ( 0u == steps ) ? 0 : ( 1u == steps ) ? 1 : ( 3u == steps ) ? -1 : QUADRATURE_INVALID;
+        CHECK_EQUAL( quadratureTable[vector], expected );
+    }
+    for( i = 0u; i < 4u; i++ )
+    {
+        CHECK_EQUAL( quadratureTable[cwOrder[i]], 1 );
+        CHECK_EQUAL( quadratureTable[ccwOrder[i]], -1 );
+    }
+    return;
+}
+
+/* Function:
+ *      CheckDetents
+ *
+ * Description:
+ *      Whole detents each way count ROT_ENC_COUNTS_PER_DETENT apiece, and a half detent followed by
+ *      a turn back counts nothing once the shaft is home.
+ */
+static void CheckDetents( void )
+{
+    int direction;
+    uint8_t detent;
+    uint8_t quarter;
+
+    EncoderTest_Reset( &encoder );
+    for( direction = ENCODER_CCW; direction <= ENCODER_CW; direction += 2 )
+    {
+        for( detent = 0u; detent < NUM_TEST_DETENTS; detent++ )
+        {
+            for( quarter = 0u; quarter < 4u; quarter++ )
+            {
+                (void) EncoderTest_QuarterStep( direction );
+            }
+        }
+        CHECK_EQUAL( RotaryEncoder_GetShaftCounts( ), direction * (int32_t) ( NUM_TEST_DETENTS * ROT_ENC_COUNTS_PER_DETENT ) );
+
+        /* Half way and back */
+        for( quarter = 0u; quarter < 2u; quarter++ )
+        {
+            (void) EncoderTest_QuarterStep( direction );
+        }
+        for( quarter = 0u; quarter < 2u; quarter++ )
+        {
+            (void) EncoderTest_QuarterStep( -direction );
+        }
+        CHECK_EQUAL( RotaryEncoder_GetShaftCounts( ), 0 );
+    }
+    CHECK_EQUAL( RotaryEncoder_GetInvalidTransitionCount( ), 0u );
+    return;
+}
+
+/* Function:
+ *      CheckBounce
+ *
+ * Description:
+ *      A pin chattering at any state of a detent may count on the way over a counting state, but
+ *      the turn back must take it away again, so the shaft back at rest has counted nothing.
+ */
+static void CheckBounce( void )
+{
+    uint8_t offset;
+    uint8_t bounce;
+    uint8_t quarter;
+    int direction;
+
+    EncoderTest_Reset( &encoder );
+    for( offset = 0u; offset < NUM_PIN_STATES; offset++ )
+    {
+        for( direction = ENCODER_CCW; direction <= ENCODER_CW; direction += 2 )
+        {
+            int32_t counts = 0;
+            for( quarter = 0u; quarter < offset; quarter++ )
+            {
+                (void) EncoderTest_QuarterStep( ENCODER_CW );
+            }
+            for( bounce = 0u; bounce < NUM_BOUNCES; bounce++ )
+            {
+                (void) EncoderTest_QuarterStep( direction );
+                counts += RotaryEncoder_GetShaftCounts( );
+                (void) EncoderTest_QuarterStep( -direction );
+                counts += RotaryEncoder_GetShaftCounts( );
+            }
+            for( quarter = 0u; quarter < offset; quarter++ )
+            {
+                (void) EncoderTest_QuarterStep( ENCODER_CCW );
+            }
+            counts += RotaryEncoder_GetShaftCounts( );
+            CHECK_EQUAL( counts, 0 );
+        }
+    }
+    CHECK_EQUAL( RotaryEncoder_GetInvalidTransitionCount( ), 0u );
+    return;
+}
+
+/* Function:
+ *      CheckInvalidTransitions
+ *
+ * Description:
+ *      A jump of two states is counted as invalid and moves nothing, and the counter saturates.
+ */
+static void CheckInvalidTransitions( void )
+{
+    unsigned jump;
+
+    EncoderTest_Reset( &encoder );
+    for( jump = 1u; jump <= 300u; jump++ )
+    {
+        encoderPhase = (uint8_t) ( encoderPhase + 2u ) & 0x3u;
+        EncoderTest_SetPins( encoderGrayCode[encoderPhase] );
+        CHECK_EQUAL( RotaryEncoder_GetInvalidTransitionCount( ), ( jump < 0xFFu ) ? jump : 0xFFu );
+    }
+    CHECK_EQUAL( RotaryEncoder_GetShaftCounts( ), 0 );
+    return;
+}
+
+int main( void )
+{
+    CheckTable( );
+    CheckDetents( );
+    CheckBounce( );
+    CheckInvalidTransitions( );
+
+    printf( "quadrature decoder, %d counts per detent\n", ROT_ENC_COUNTS_PER_DETENT );
+    printf( "  table                 : %u bytes of flash\n", (unsigned) sizeof (quadratureTable ) );
+
+    return HostTest_Finish( "test_encoder_quadrature" );
+}
+
+/* End test_encoder_quadrature.c source file */
@@ -0,0 +1,11 @@
+/* Filename: test_encoder_quadrature_x2.c
+ *
+ * Description: test_encoder_quadrature.c with 2 counts per detent.
+ *
+ */
+
+#define ROT_ENC_COUNTS_PER_DETENT 2
+
+#include "test_encoder_quadrature.c"
+
+/* End test_encoder_quadrature_x2.c source file */
@@ -0,0 +1,11 @@
+/* Filename: test_encoder_quadrature_x4.c
+ *
+ * Description: test_encoder_quadrature.c with 4 counts per detent.
+ *
+ */
+
+#define ROT_ENC_COUNTS_PER_DETENT 4
+
+#include "test_encoder_quadrature.c"
+
+/* End test_encoder_quadrature_x4.c source file */
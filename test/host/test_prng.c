@@ -0,0 +1,143 @@
+/* Filename: test_prng.c
+ *
+ * Description: Host test of the 16 bit xorshift generator in prng.c.
+ *
+ *      The generator must visit every nonzero state exactly once before it repeats, a period of
+ *      65535, and a zero seed must not lock it at zero. The popcorn effect picks its pixel with
+ *      PRNG_Next8( ) & 63, so over a whole period each of the 64 pixels must come up 1024 times,
+ *      except pixel 0, which loses the zero state. Shorter runs from a spread of seeds must also
+ *      pass a chi-squared test against an even spread.
+ *
+ */
+
+#include "prng.c"
+#include "host_test.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define NUM_STATES 65536ul
+#define PRNG_PERIOD ( NUM_STATES - 1u )
+#define NUM_PIXEL_BUCKETS 64u
+#define PIXEL_MASK ( NUM_PIXEL_BUCKETS - 1u )
+#define DRAWS_PER_BUCKET ( NUM_STATES / NUM_PIXEL_BUCKETS )
+
+/* Short runs: 100 draws per bucket, checked against the 99.9% point of chi-squared with 63
+ * degrees of freedom */
+#define SHORT_RUN_DRAWS ( 100u * NUM_PIXEL_BUCKETS )
+#define CHI_SQUARED_LIMIT 103.4
+#define NUM_SHORT_RUN_SEEDS 64u
+
+
+/****************** Local Variable(s) *********************/
+static bool isStateSeen[NUM_STATES];
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      CheckPeriod
+ *
+ * Description:
+ *      Runs from the default seed until it comes back round. Every nonzero state must come up once
+ *      on the way, and zero never.
+ */
+static unsigned long CheckPeriod( void )
+{
+    unsigned long period = 0u;
+    uint16_t state;
+
+    PRNG_Seed( 0u );
+    CHECK_EQUAL( prngState, PRNG_DEFAULT_SEED );
+
+    do
+    {
+        state = PRNG_Next16( );
+        period++;
+        CHECK( 0u != state );
+        CHECK( !isStateSeen[state] );
+        isStateSeen[state] = true;
+    } while( ( PRNG_DEFAULT_SEED != state ) && ( period <= NUM_STATES ) );
+    CHECK_EQUAL( period, PRNG_PERIOD );
+    return period;
+}
+
+/* Function:
+ *      CheckFullPeriodSpread
+ *
+ * Description:
+ *      Counts PRNG_Next8( ) & 63 over one whole period.
+ */
+static void CheckFullPeriodSpread( void )
+{
+    unsigned long buckets[NUM_PIXEL_BUCKETS] = {0u};
+    unsigned long draw;
+    uint8_t bucket;
+
+    PRNG_Seed( 1u );
+    for( draw = 0u; draw < PRNG_PERIOD; draw++ )
+    {
+        buckets[PRNG_Next8( ) & PIXEL_MASK]++;
+    }
+    for( bucket = 0u; bucket < NUM_PIXEL_BUCKETS; bucket++ )
+    {
+        CHECK_EQUAL( buckets[bucket], ( 0u == bucket ) ? DRAWS_PER_BUCKET - 1u : DRAWS_PER_BUCKET );
+    }
+    return;
+}
+
+/* Function:
+ *      CheckShortRunSpread
+ *
+ * Description:
+ *      Chi-squared of PRNG_Next8( ) & 63 over SHORT_RUN_DRAWS draws from each of a spread of seeds,
+ *      the way patternMode.c seeds from the knob. Returns the worst statistic seen.
+ */
+static double CheckShortRunSpread( void )
+{
+    double worst = 0.0;
+    unsigned seedIdx;
+
+    for( seedIdx = 0u; seedIdx < NUM_SHORT_RUN_SEEDS; seedIdx++ )
+    {
+        unsigned long buckets[NUM_PIXEL_BUCKETS] = {0u};
+        double expected = (double) SHORT_RUN_DRAWS / NUM_PIXEL_BUCKETS;
+        double chiSquared = 0.0;
+        unsigned draw;
+        uint8_t bucket;
+
+        PRNG_Seed( (uint16_t) ( seedIdx * 1021u + 1u ) );
+        for( draw = 0u; draw < SHORT_RUN_DRAWS; draw++ )
+        {
+            buckets[PRNG_Next8( ) & PIXEL_MASK]++;
+        }
+        for( bucket = 0u; bucket < NUM_PIXEL_BUCKETS; bucket++ )
+        {
+            double difference = (double) buckets[bucket] - expected;
+            chiSquared += difference * difference / expected;
+        }
+        CHECK( chiSquared < CHI_SQUARED_LIMIT );
+        if( chiSquared > worst )
+        {
+            worst = chiSquared;
+        }
+    }
+    return worst;
+}
+
+int main( void )
+{
+    unsigned long period = CheckPeriod( );
+    CheckFullPeriodSpread( );
+    double worstChiSquared = CheckShortRunSpread( );
+
+    printf( "xorshift16 (7, 9, 8) generator\n" );
+    printf( "  period                : %lu states\n", period );
+    printf( "  pixel spread          : %u draws per pixel per period, worst chi-squared %.1f of %u seeds (limit %.1f)\n",
+            (unsigned) DRAWS_PER_BUCKET, worstChiSquared, NUM_SHORT_RUN_SEEDS, CHI_SQUARED_LIMIT );
+
+    return HostTest_Finish( "test_prng" );
+}
+
+/* End test_prng.c source file */
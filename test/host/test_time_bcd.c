@@ -0,0 +1,326 @@
+/* Filename: test_time_bcd.c
+ *
+ * Description: Host test of the packed BCD time kept by the tick ISR in timeCalculation.c, built
+ *      with the real tmr5.c and CRC16bit.c.
+ *
+ *      Checks the BCD helpers on every value, then ticks the ISR through more than twelve hours
+ *      and compares every second against a plain division reference, including the 12:59:59 to
+ *      1:00:00 rollover and the minute rolled flag. The main loop poll is then run several times
+ *      per tick to check it renders exactly once per minute change, with the right digits, and
+ *      that encoder edits show at once and wrap at the ends of the dial.
+ *
+ *      The baseline poll is kept here as Legacy_RenderIfMinutesHaveChanged: a 32 bit seconds count
+ *      the ISR incremented, and a poll that added the encoder delta, clamped, and divided by 60 on
+ *      every call. Both polls are single stepped over the same run of ticks to count host
+ *      instructions per poll. On the PIC the 32 bit division is a library call, so the host count
+ *      understates the baseline's cost.
+ *
+ */
+
+#include "timeCalculation.c"
+#include "mcc_generated_files/tmr5.c"
+#include "CRC16bit.c"
+#include "time_test.h"
+#include "step.h"
+#include <stdio.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define IDLE_POLLS_PER_TICK 10u
+#define NUM_IDLE_TEST_SECONDS ( 2ul * 3600ul )
+#define NUM_BENCH_SECONDS 600ul
+
+
+/****************** Local Variable(s) *********************/
+static volatile uint32_t legacyTimeInSeconds = 0u; // The baseline's seconds since 1:00:00
+
+
+/*********************** Function(s) **********************/
+
+static void NoHook( unsigned long step )
+{
+    return;
+}
+
+/* Function:
+ *      Legacy_IncrementSecondsISR
+ *
+ * Description:
+ *      The baseline tick: one 32 bit increment with a wrap past 12:59:59.
+ */
+static void Legacy_IncrementSecondsISR( void )
+{
+    legacyTimeInSeconds = ( legacyTimeInSeconds + 1u > MAX_NUM_SECONDS ) ? 0u : legacyTimeInSeconds + 1u;
+    return;
+}
+
+/* Function:
+ *      Legacy_RenderIfMinutesHaveChanged
+ *
+ * Description:
+ *      The baseline poll. Adds the encoder delta, clamps, and divides down to minutes on every
+ *      call, whether or not anything changed.
+ */
+static void Legacy_RenderIfMinutesHaveChanged( bool isSwitchPressHrMnMode )
+{
+    static uint16_t minutesAtLastChange = 0xFFFF;
+
+    int32_t minutesDelta = RotaryEncoder_GetShaftCounts( );
+
+    if( isSwitchPressHrMnMode )
+    {
+        minutesDelta *= 60u;
+    }
+
+    int32_t thisTimeInSeconds = (int32_t) legacyTimeInSeconds + ( minutesDelta * NUM_COUNTS_PER_SECOND );
+    thisTimeInSeconds = ( thisTimeInSeconds < 0 ) ? (int32_t) MAX_NUM_SECONDS :
+            ( thisTimeInSeconds > (int32_t) MAX_NUM_SECONDS ) ? 0 : thisTimeInSeconds;
+    legacyTimeInSeconds = (volatile uint32_t) thisTimeInSeconds;
+    uint16_t currentTimeInMinutes = (uint16_t) ( legacyTimeInSeconds / NUM_SECONDS_IN_MINUTE );
+
+    if( currentTimeInMinutes != minutesAtLastChange )
+    {
+        minutesAtLastChange = currentTimeInMinutes;
+        uint8_t hours = (uint8_t) ( currentTimeInMinutes / NUM_MINUTES_IN_HOURS ) + 1u;
+        uint8_t minutes = (uint8_t) ( currentTimeInMinutes % NUM_MINUTES_IN_HOURS );
+
+        TimeInDigits t = {
+            .digit1 = ( hours % 100 ) / 10,
+            .digit2 = ( hours % 10 ),
+            .digit3 = ( minutes % 100 ) / 10,
+            .digit4 = ( minutes % 10 )
+        };
+
+        Clock_WriteTimeDigitValuesAndRenderScreen( &t );
+    }
+    return;
+}
+
+static void Legacy_PollBody( void )
+{
+    Legacy_RenderIfMinutesHaveChanged( false );
+    return;
+}
+
+static void Bcd_PollBody( void )
+{
+    Time_RenderIfMinutesHaveChanged( false );
+    return;
+}
+
+/* Function:
+ *      CheckBcdHelpers
+ *
+ * Description:
+ *      Conversions must round trip for 0 to 99, and an increment must step to the next BCD value
+ *      and wrap to zero past the maximum.
+ */
+static void CheckBcdHelpers( void )
+{
+    const uint8_t maxima[] = {BCD_MAX_SECONDS, BCD_MAX_HOURS};
+    uint8_t value;
+    uint8_t i;
+
+    for( value = 0u; value < 100u; value++ )
+    {
+        CHECK_EQUAL( Time_BcdToBinary( Time_BinaryToBcd( value ) ), value );
+        CHECK_EQUAL( Time_BinaryToBcd( value ), ( ( value / 10u ) << 4u ) | ( value % 10u ) );
+    }
+
+    for( i = 0u; i < sizeof (maxima ); i++ )
+    {
+        uint8_t maxBinary = Time_BcdToBinary( maxima[i] );
+        for( value = 0u; value <= maxBinary; value++ )
+        {
+            volatile uint8_t bcdValue = Time_BinaryToBcd( value );
+            bool hasWrapped = Time_IncrementBcd( &bcdValue, maxima[i] );
+            CHECK_EQUAL( hasWrapped, value == maxBinary );
+            CHECK_EQUAL( bcdValue, hasWrapped ? 0u : Time_BinaryToBcd( value + 1u ) );
+        }
+    }
+    return;
+}
+
+/* Function:
+ *      CheckTicks
+ *
+ * Description:
+ *      Every tick advances one second, flags exactly the minute changes, and bumps the sequence.
+ */
+static void CheckTicks( void )
+{
+    unsigned long second;
+    uint8_t sequence = timeSequence;
+
+    TimeTest_CheckTime( 0u );
+    for( second = 1u; second <= SECONDS_PER_12_HOURS + 3600u; second++ )
+    {
+        hasMinuteRolled = false;
+        Time_IncrementSecondsISR( );
+        sequence++;
+        TimeTest_CheckTime( second );
+        CHECK_EQUAL( hasMinuteRolled, 0u == ( second % 60u ) );
+        CHECK_EQUAL( timeSequence, sequence );
+        CHECK_EQUAL( Time_GetCurrentTimeInSeconds( ), second % SECONDS_PER_12_HOURS );
+    }
+    return;
+}
+
+/* Function:
+ *      CheckIdlePolling
+ *
+ * Description:
+ *      Polls the main loop function IDLE_POLLS_PER_TICK times per second. Only a minute change may
+ *      render. Returns the number of polls made.
+ */
+static unsigned long CheckIdlePolling( unsigned long * const secondsSinceOne )
+{
+    unsigned long second;
+    unsigned long numPolls = 0u;
+    uint8_t poll;
+
+    hasMinuteRolled = true;
+    Time_RenderIfMinutesHaveChanged( false );
+    numPolls++;
+    TimeTest_CheckRenderedTime( *secondsSinceOne );
+    numRenders = 0u;
+
+    for( second = 0u; second < NUM_IDLE_TEST_SECONDS; second++ )
+    {
+        Time_IncrementSecondsISR( );
+        ( *secondsSinceOne )++;
+        for( poll = 0u; poll < IDLE_POLLS_PER_TICK; poll++ )
+        {
+            Time_RenderIfMinutesHaveChanged( false );
+            numPolls++;
+        }
+        TimeTest_CheckRenderedTime( *secondsSinceOne );
+    }
+    CHECK_EQUAL( numRenders, NUM_IDLE_TEST_SECONDS / 60u );
+    return numPolls;
+}
+
+/* Function:
+ *      BenchmarkPolls
+ *
+ * Description:
+ *      Ticks both clocks from the same time for NUM_BENCH_SECONDS and single steps each poll
+ *      IDLE_POLLS_PER_TICK times per tick. Both must render the same digits once per minute
+ *      change. Totals the instructions each path ran and returns the number of polls per path.
+ */
+static unsigned long BenchmarkPolls( unsigned long * const secondsSinceOne,
+                                     unsigned long * const legacyInstructions,
+                                     unsigned long * const bcdInstructions )
+{
+    unsigned long second;
+    unsigned long numPolls = 0u;
+    unsigned long numLegacyRenders = 0u;
+    uint8_t poll;
+
+    *legacyInstructions = 0u;
+    *bcdInstructions = 0u;
+    legacyTimeInSeconds = *secondsSinceOne % SECONDS_PER_12_HOURS;
+    Legacy_RenderIfMinutesHaveChanged( false );
+    TimeTest_CheckRenderedTime( *secondsSinceOne );
+
+    for( second = 0u; second < NUM_BENCH_SECONDS; second++ )
+    {
+        Legacy_IncrementSecondsISR( );
+        Time_IncrementSecondsISR( );
+        ( *secondsSinceOne )++;
+        for( poll = 0u; poll < IDLE_POLLS_PER_TICK; poll++ )
+        {
+            unsigned long numPollRenders;
+
+            numRenders = 0u;
+            *legacyInstructions += Step_Run( Legacy_PollBody, NoHook );
+            TimeTest_CheckRenderedTime( *secondsSinceOne );
+            numPollRenders = numRenders;
+            numLegacyRenders += numPollRenders;
+
+            numRenders = 0u;
+            *bcdInstructions += Step_Run( Bcd_PollBody, NoHook );
+            TimeTest_CheckRenderedTime( *secondsSinceOne );
+            CHECK_EQUAL( numRenders, numPollRenders );
+            numPolls++;
+        }
+    }
+    CHECK_EQUAL( numLegacyRenders, NUM_BENCH_SECONDS / 60u );
+    return numPolls;
+}
+
+/* Function:
+ *      CheckEncoderEdits
+ *
+ * Description:
+ *      Encoder counts move the minutes, or the hours in hour mode, on the very next poll and in
+ *      the ISR's time on the next tick. Going below 1:00 gives 12:59:59, past 12:59 gives 1:00:00.
+ */
+static void CheckEncoderEdits( unsigned long secondsSinceOne )
+{
+    unsigned long seconds = secondsSinceOne % 60u;
+    unsigned long minuteStart = secondsSinceOne - seconds;
+
+    testShaftCounts = 5;
+    Time_RenderIfMinutesHaveChanged( false );
+    minuteStart += 5u * 60u;
+    TimeTest_CheckRenderedTime( minuteStart );
+    Time_IncrementSecondsISR( );
+    TimeTest_CheckTime( minuteStart + seconds + 1u );
+    seconds++;
+
+    testShaftCounts = -2;
+    Time_RenderIfMinutesHaveChanged( true );
+    minuteStart = ( minuteStart + SECONDS_PER_12_HOURS - 2u * 3600u ) % SECONDS_PER_12_HOURS;
+    TimeTest_CheckRenderedTime( minuteStart );
+    Time_IncrementSecondsISR( );
+    TimeTest_CheckTime( minuteStart + seconds + 1u );
+
+    /* Below 1:00 */
+    testShaftCounts = -(int32_t) ( minuteStart / 60u ) - 1;
+    Time_RenderIfMinutesHaveChanged( false );
+    TimeTest_CheckRenderedTime( SECONDS_PER_12_HOURS - 1u );
+    Time_IncrementSecondsISR( );
+    TimeTest_CheckTime( 0u ); // 12:59:59 plus the tick
+
+    /* Past 12:59 */
+    testShaftCounts = 12 * 60;
+    Time_RenderIfMinutesHaveChanged( false );
+    TimeTest_CheckRenderedTime( 0u );
+    Time_IncrementSecondsISR( );
+    TimeTest_CheckTime( 1u );
+    return;
+}
+
+int main( void )
+{
+    unsigned long secondsSinceOne = SECONDS_PER_12_HOURS + 3600u;
+
+    Time_InitializeTimeModule( );
+    CheckBcdHelpers( );
+    CheckTicks( );
+    unsigned long numPolls = CheckIdlePolling( &secondsSinceOne );
+    unsigned long legacyInstructions;
+    unsigned long bcdInstructions;
+    unsigned long numBenchPolls = BenchmarkPolls( &secondsSinceOne, &legacyInstructions, &bcdInstructions );
+    CheckEncoderEdits( secondsSinceOne );
+
+    printf( "BCD time, %lu s of ticks polled %u times per tick\n", NUM_IDLE_TEST_SECONDS, IDLE_POLLS_PER_TICK );
+    printf( "  polls                 : %lu, %lu rendered (one per minute change)\n",
+            numPolls, NUM_IDLE_TEST_SECONDS / 60u );
+    if( STEP_IS_SUPPORTED )
+    {
+        printf( "  per poll              : %lu.%02lu host instructions with a 32 bit add, clamp and divide, %lu.%02lu with the BCD flag (%lu polls, %lu s)\n",
+                legacyInstructions / numBenchPolls, ( legacyInstructions * 100u / numBenchPolls ) % 100u,
+                bcdInstructions / numBenchPolls, ( bcdInstructions * 100u / numBenchPolls ) % 100u,
+                numBenchPolls, NUM_BENCH_SECONDS );
+    }
+    else
+    {
+        printf( "  instruction counts    : single stepping needs an x86-64 Linux host, skipped\n" );
+    }
+
+    return HostTest_Finish( "test_time_bcd" );
+}
+
+/* End test_time_bcd.c source file */
@@ -0,0 +1,217 @@
+/* Filename: test_time_seqlock.c
+ *
+ * Description: Host stress test of the tick ISR's time handoff in timeCalculation.c, built with
+ *      the real tmr5.c and CRC16bit.c.
+ *
+ *      The main loop side is single stepped, and the tick ISR is run once after each of its
+ *      instructions in turn, so every interleaving of one tick with a snapshot or an encoder edit
+ *      is tried. A snapshot must show the time before or after the tick, never a mix of the two.
+ *      An edit must land exactly once, whether or not the ISR still holds the previous one, and the
+ *      next poll must show the tick and the edit together.
+ *
+ */
+
+#include "timeCalculation.c"
+#include "mcc_generated_files/tmr5.c"
+#include "CRC16bit.c"
+#include "time_test.h"
+#include "step.h"
+#include <limits.h>
+#include <stdio.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define NO_TICK_STEP ULONG_MAX
+#define NUM_TICKS_AFTER_EDIT 2u
+#define PENDING_HANDOFF_MINUTES 3
+
+
+/****************** Local Variable(s) *********************/
+static volatile unsigned long tickAtStep = NO_TICK_STEP;
+static volatile uint32_t snapshotSeconds = 0u;
+static volatile bool editIsHourMode = false;
+static unsigned long numRetriedSnapshots = 0u;
+static unsigned long numInterleavings = 0u;
+
+/* Tick times where the ISR changes more than one byte of the time */
+static const unsigned long rolloverStarts[] = {
+    59u,                         // 1:00:59
+    9u * 60u + 59u,              // 1:09:59
+    3600u - 1u,                  // 1:59:59
+    9u * 3600u - 1u,             // 9:59:59
+    SECONDS_PER_12_HOURS - 1u    // 12:59:59
+};
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      SetTime
+ *
+ * Description:
+ *      Puts the ISR's time at the given seconds since 1:00:00 with no edits in flight.
+ */
+static void SetTime( const unsigned long secondsSinceOne )
+{
+    BcdTime t = TimeTest_ExpectedBcd( secondsSinceOne );
+    currentTime.hours = t.hours;
+    currentTime.minutes = t.minutes;
+    currentTime.seconds = t.seconds;
+    isAdjustmentPending = false;
+    pendingAdjustmentMinutes = 0;
+    queuedAdjustmentMinutes = 0;
+    hasMinuteRolled = false;
+    return;
+}
+
+/* Function:
+ *      TickAtStep
+ *
+ * Description:
+ *      Step hook. Runs the tick ISR after the chosen instruction.
+ */
+static void TickAtStep( unsigned long step )
+{
+    if( step == tickAtStep )
+    {
+        Time_IncrementSecondsISR( );
+    }
+    return;
+}
+
+static void ReadSnapshotBody( void )
+{
+    snapshotSeconds = Time_GetCurrentTimeInSeconds( );
+    return;
+}
+
+static void EditBody( void )
+{
+    Time_RenderIfMinutesHaveChanged( editIsHourMode );
+    return;
+}
+
+/* Function:
+ *      CheckSnapshotRace
+ *
+ * Description:
+ *      Ticks once after every instruction of a snapshot in turn. The snapshot must read the time
+ *      before or after the tick, and the tick itself must not be lost.
+ */
+static void CheckSnapshotRace( const unsigned long startSeconds )
+{
+    unsigned long afterSeconds = ( startSeconds + 1u ) % SECONDS_PER_12_HOURS;
+    unsigned long numSteps;
+    unsigned long step;
+
+    SetTime( startSeconds );
+    tickAtStep = NO_TICK_STEP;
+    numSteps = Step_Run( ReadSnapshotBody, TickAtStep );
+    CHECK_EQUAL( snapshotSeconds, startSeconds );
+
+    for( step = 1u; step <= numSteps; step++ )
+    {
+        uint8_t sequence;
+        SetTime( startSeconds );
+        sequence = timeSequence;
+        tickAtStep = step;
+        unsigned long numStepsTicked = Step_Run( ReadSnapshotBody, TickAtStep );
+
+        CHECK( ( snapshotSeconds == startSeconds ) || ( snapshotSeconds == afterSeconds ) );
+        CHECK_EQUAL( timeSequence, (uint8_t) ( sequence + 1u ) );
+        TimeTest_CheckTime( afterSeconds );
+        numInterleavings++;
+        if( numStepsTicked > numSteps )
+        {
+            numRetriedSnapshots++;
+        }
+    }
+    return;
+}
+
+/* Function:
+ *      CheckEditRace
+ *
+ * Description:
+ *      Ticks once after every instruction of an encoder edit in turn, optionally with an earlier
+ *      edit still held by the ISR. The next poll must render the tick and both edits, and a few
+ *      more ticks must leave exactly that in the ISR's time.
+ */
+static void CheckEditRace( const unsigned long startSeconds,
+                           const int32_t shaftCounts,
+                           const bool isHourMode,
+                           const bool hasPendingHandoff )
+{
+    int32_t editMinutes = shaftCounts * ( isHourMode ? 60 : 1 ) + ( hasPendingHandoff ? PENDING_HANDOFF_MINUTES : 0 );
+    unsigned long editedSeconds = startSeconds + (unsigned long) ( editMinutes * 60 );
+    unsigned long numSteps;
+    unsigned long step;
+
+    editIsHourMode = isHourMode;
+    tickAtStep = NO_TICK_STEP;
+    SetTime( startSeconds );
+    testShaftCounts = shaftCounts;
+    numSteps = Step_Run( EditBody, TickAtStep );
+
+    for( step = 1u; step <= numSteps; step++ )
+    {
+        uint8_t tick;
+        SetTime( startSeconds );
+        if( hasPendingHandoff )
+        {
+            pendingAdjustmentMinutes = PENDING_HANDOFF_MINUTES;
+            isAdjustmentPending = true;
+        }
+        testShaftCounts = shaftCounts;
+        tickAtStep = step;
+        (void) Step_Run( EditBody, TickAtStep );
+        numInterleavings++;
+
+        Time_RenderIfMinutesHaveChanged( false );
+        TimeTest_CheckRenderedTime( editedSeconds + 1u );
+
+        for( tick = 0u; tick < NUM_TICKS_AFTER_EDIT; tick++ )
+        {
+            Time_IncrementSecondsISR( );
+            Time_RenderIfMinutesHaveChanged( false );
+        }
+        TimeTest_CheckTime( editedSeconds + 1u + NUM_TICKS_AFTER_EDIT );
+        TimeTest_CheckRenderedTime( editedSeconds + 1u + NUM_TICKS_AFTER_EDIT );
+        CHECK( !isAdjustmentPending );
+        CHECK_EQUAL( queuedAdjustmentMinutes, 0 );
+    }
+    return;
+}
+
+int main( void )
+{
+    size_t i;
+
+    Time_InitializeTimeModule( );
+    if( !STEP_IS_SUPPORTED )
+    {
+        printf( "time seqlock: single stepping needs an x86-64 Linux host, skipped\n" );
+        return HostTest_Finish( "test_time_seqlock" );
+    }
+
+    for( i = 0u; i < sizeof (rolloverStarts ) / sizeof (rolloverStarts[0] ); i++ )
+    {
+        CheckSnapshotRace( rolloverStarts[i] );
+    }
+    unsigned long numSnapshotInterleavings = numInterleavings;
+
+    /* Away from the 1:00 and 12:59 limits, so the edits add plainly */
+    CheckEditRace( 4u * 3600u + 30u * 60u + 59u, 7, false, false );
+    CheckEditRace( 4u * 3600u + 30u * 60u + 59u, 7, false, true );
+    CheckEditRace( 4u * 3600u + 30u * 60u + 59u, -45, false, true );
+    CheckEditRace( 4u * 3600u + 30u * 60u + 59u, 2, true, false );
+    CheckEditRace( 4u * 3600u + 30u * 60u + 59u, -3, true, true );
+
+    printf( "time seqlock, one tick after every instruction of the main loop side\n" );
+    printf( "  snapshots             : %lu interleavings, %lu retried\n", numSnapshotInterleavings, numRetriedSnapshots );
+    printf( "  encoder edits         : %lu interleavings\n", numInterleavings - numSnapshotInterleavings );
+
+    return HostTest_Finish( "test_time_seqlock" );
+}
+
+/* End test_time_seqlock.c source file */
@@ -0,0 +1,231 @@
+/* Filename: test_time_trim.c
+ *
+ * Description: Host simulation of the TMR5 timebase, the missed period catch up, and the ppm trim
+ *      in timeCalculation.c, built with the real tmr5.c and CRC16bit.c.
+ *
+ *      TMR5 is modelled in counts of its clock. At every overflow the ISR is entered after a short
+ *      random latency, with TMR5 holding the counts since it wrapped through zero. Every so often
+ *      interrupts are held off for a few whole periods, which TMR5_ISR must count and the tick ISR
+ *      must credit. The next overflow must land a whole period after the last one however late the
+ *      ISR ran.
+ *
+ *      A day of ticks is run for oscillators off by a range of errors, each with the trim a user
+ *      would settle on, and the clock must stay within TRIM_DRIFT_BOUND_S of real time after every
+ *      tick. The trim must persist through EEPROM, and reading it must leave TMR5IE as it was.
+ *
+ */
+
+#include "timeCalculation.c"
+#include "mcc_generated_files/tmr5.c"
+#include "CRC16bit.c"
+#include "time_test.h"
+#include <math.h>
+#include <stdio.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define SECONDS_PER_DAY 86400.0
+#define TIMER_COUNTS 65536ul
+
+/* The clock ticks and the trim corrects in whole seconds, and the chosen trim is within half a
+ * ppm of ideal, which is 0.05 s over a day */
+#define TRIM_DRIFT_BOUND_S 1.05
+
+#define MAX_LATENCY_COUNTS 4u // ISR latency at every overflow, in timer counts
+#define MASKED_WINDOW_INTERVAL 997u // Overflows between long interrupt masked windows
+
+
+/****************** Type Definition(s) ********************/
+typedef struct
+{
+    const char * name;
+    uint16_t reloadValue;
+    double countsPerSecond; // Nominal
+    double errorPpm; // How fast the oscillator actually runs
+    uint8_t maxMissedPeriods; // Longest masked window, in whole periods
+} TrimCase;
+
+typedef struct
+{
+    double maxDriftSeconds;
+    double untrimmedDriftSeconds; // At the end of the day, had every overflow counted one second
+    unsigned long numTicks;
+    unsigned long missedPeriods;
+} TrimResult;
+
+
+/****************** Local Variable(s) *********************/
+static uint32_t randomState = 12345u;
+
+static const TrimCase trimCases[] = {
+    {"LFINTOSC 2% slow", 0xF0DDu, 3875.0, -20000.0, 5u},
+    {"LFINTOSC 231 ppm slow", 0xF0DDu, 3875.0, -231.48, 5u},
+    {"LFINTOSC 1.5% fast", 0xF0DDu, 3875.0, 15000.0, 5u},
+    {"LFINTOSC exact", 0xF0DDu, 3875.0, 0.0, 5u},
+    {"SOSC 20 ppm fast", SOSC_RELOAD_VALUE, 32768.0, 20.0, 1u}
+};
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      NextRandom
+ *
+ * Description:
+ *      Small deterministic LCG for the latencies, so every run sees the same schedule.
+ */
+static uint32_t NextRandom( const uint32_t range )
+{
+    randomState = randomState * 1664525u + 1013904223u;
+    return ( randomState >> 8u ) % range;
+}
+
+/* Function:
+ *      IdealTrimPpm
+ *
+ * Description:
+ *      The trim that makes an oscillator errorPpm fast keep real time. The ISR adds the trim per
+ *      tick, not per real second, so this is not simply -errorPpm for large errors.
+ */
+static int16_t IdealTrimPpm( const double errorPpm )
+{
+    return (int16_t) lround( 1e6 / ( 1.0 + errorPpm / 1e6 ) - 1e6 );
+}
+
+/* Function:
+ *      ElapsedClockSeconds
+ *
+ * Description:
+ *      Seconds the clock has advanced since the last call, across the 12 hour wrap.
+ */
+static unsigned long ElapsedClockSeconds( uint32_t * const lastSeconds )
+{
+    uint32_t seconds = Time_GetCurrentTimeInSeconds( );
+    unsigned long elapsed = ( seconds + SECONDS_PER_12_HOURS - *lastSeconds ) % SECONDS_PER_12_HOURS;
+    *lastSeconds = seconds;
+    return elapsed;
+}
+
+/* Function:
+ *      RunDay
+ *
+ * Description:
+ *      Runs TMR5 and its ISR for a day of real time at the case's oscillator error with the given
+ *      trim. Checks the overflow phase and the lost tick count at every ISR, and returns the worst
+ *      drift from real time at the overflows counted so far.
+ */
+static TrimResult RunDay( const TrimCase * const c,
+                          const int16_t trim )
+{
+    TrimResult result = {0.0, 0.0, 0u, 0u};
+    unsigned long periodCounts = TIMER_COUNTS - c->reloadValue;
+    double countsPerRealSecond = c->countsPerSecond * ( 1.0 + c->errorPpm / 1e6 );
+    unsigned long dayCounts = (unsigned long) ( SECONDS_PER_DAY * countsPerRealSecond );
+    unsigned long overflowAt = periodCounts;
+    unsigned long clockSeconds = 0u;
+    uint32_t lastSeconds;
+    uint16_t startLostTickCount = Time_GetLostTickCount( );
+
+    timer5ReloadVal = c->reloadValue;
+    (void) TMR5_TakeMissedPeriods( );
+    trimPpm = trim;
+    trimAccumulatorPpm = 0;
+    lastSeconds = Time_GetCurrentTimeInSeconds( );
+
+    while( overflowAt < dayCounts )
+    {
+        unsigned long latency = NextRandom( MAX_LATENCY_COUNTS + 1u );
+        unsigned long missed = 0u;
+        if( 0u == ( result.numTicks % MASKED_WINDOW_INTERVAL ) )
+        {
+            missed = 1u + NextRandom( c->maxMissedPeriods );
+            latency += NextRandom( (uint32_t) periodCounts );
+        }
+        unsigned long entryAt = overflowAt + missed * periodCounts + latency;
+
+        /* The counter wrapped through zero at the overflow and has counted since */
+        unsigned long sinceWrap = entryAt - overflowAt;
+        TMR5H = (uint8_t) ( sinceWrap >> 8u );
+        TMR5L = (uint8_t) sinceWrap;
+        TMR5_ISR( );
+        unsigned long writtenValue = ( (unsigned long) TMR5H << 8u ) | TMR5L;
+
+        CHECK_EQUAL( entryAt + ( TIMER_COUNTS - writtenValue ), overflowAt + ( missed + 1u ) * periodCounts );
+        overflowAt += missed * periodCounts; // The last overflow the ISR has accounted for
+        result.missedPeriods += missed;
+        CHECK_EQUAL( (uint16_t) ( Time_GetLostTickCount( ) - startLostTickCount ), (uint16_t) result.missedPeriods );
+
+        clockSeconds += ElapsedClockSeconds( &lastSeconds );
+        double drift = (double) clockSeconds - (double) overflowAt / countsPerRealSecond;
+        if( fabs( drift ) > result.maxDriftSeconds )
+        {
+            result.maxDriftSeconds = fabs( drift );
+        }
+        result.numTicks++;
+        result.untrimmedDriftSeconds = (double) ( result.numTicks + result.missedPeriods ) - (double) overflowAt / countsPerRealSecond;
+        overflowAt += periodCounts;
+    }
+    return result;
+}
+
+/* Function:
+ *      CheckTrimStorage
+ *
+ * Description:
+ *      A saved trim comes back on the next initialization, a corrupt block is ignored, and setting
+ *      or reading the trim, or reading the lost tick count, leaves the tick interrupt enable as it
+ *      found it.
+ */
+static void CheckTrimStorage( void )
+{
+    uint8_t tickEnable;
+
+    for( tickEnable = 0u; tickEnable <= 1u; tickEnable++ )
+    {
+        PIE4bits.TMR5IE = tickEnable;
+        CHECK( Time_SetTrimPpm( -1234 ) );
+        CHECK_EQUAL( PIE4bits.TMR5IE, tickEnable );
+        CHECK_EQUAL( Time_GetTrimPpm( ), -1234 );
+        CHECK_EQUAL( PIE4bits.TMR5IE, tickEnable );
+        (void) Time_GetLostTickCount( );
+        CHECK_EQUAL( PIE4bits.TMR5IE, tickEnable );
+    }
+
+    trimPpm = 0;
+    Time_InitializeTimeModule( );
+    CHECK_EQUAL( Time_GetTrimPpm( ), -1234 );
+
+    testEeprom[EEPROM_ADDR_TRIM_LB & TEST_EEPROM_ADDR_MASK] ^= 0x01u;
+    trimPpm = 0;
+    Time_InitializeTimeModule( );
+    CHECK_EQUAL( Time_GetTrimPpm( ), 0 );
+
+    CHECK( Time_SetTrimPpm( 0 ) );
+    return;
+}
+
+int main( void )
+{
+    size_t i;
+
+    TMR5_Initialize( );
+    CHECK_EQUAL( timer5ReloadVal, 0xF0DDu );
+    Time_InitializeTimeModule( );
+    CheckTrimStorage( );
+
+    printf( "TMR5 trim and catch up, a day of real time per oscillator\n" );
+    for( i = 0u; i < sizeof (trimCases ) / sizeof (trimCases[0] ); i++ )
+    {
+        const TrimCase * c = &trimCases[i];
+        int16_t trim = IdealTrimPpm( c->errorPpm );
+        TrimResult result = RunDay( c, trim );
+        CHECK( result.maxDriftSeconds <= TRIM_DRIFT_BOUND_S );
+        CHECK( result.missedPeriods > 0u );
+        printf( "  %-22s: trim %+6d ppm, %+8.1f s/day untrimmed, worst %.2f s trimmed, %lu periods caught up\n",
+                c->name, trim, result.untrimmedDriftSeconds, result.maxDriftSeconds, result.missedPeriods );
+    }
+
+    return HostTest_Finish( "test_time_trim" );
+}
+
+/* End test_time_trim.c source file */
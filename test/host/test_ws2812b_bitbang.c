@@ -0,0 +1,190 @@
+/* Filename: test_ws2812b_bitbang.c
+ *
+ * Description: Off-target waveform recorder for the bit bang transport. ws2812b.c is compiled
+ *      with its pin and cycle primitives replaced by functions that advance a simulated
+ *      instruction clock and log every pin change: a pin write or WS2812B_CYCLE is one cycle, and
+ *      the conditional drop is two on both paths, as btfss/bcf is. The unrolled bit code is
+ *      therefore recorded exactly. The C between two WRITE_BYTEs is not simulated, each byte gap
+ *      is charged the worst case the driver budgets for it instead.
+ *
+ *      The recording is decoded back into pixels, compared against the gamma corrected buffer,
+ *      and every high and low time is checked against the WS2812B_*_NS limits. Prints cycles per
+ *      frame, frame time, bit rate, and the longest window with interrupts masked.
+ *
+ */
+
+#include "sim.h"
+
+/****************** Recorder Primitive(s) *****************/
+static void Sim_PinHigh( void );
+static void Sim_PinLow( void );
+static void Sim_PinLowIfClear( const uint8_t byte,
+                               const uint8_t mask );
+static void Sim_Cycle( void );
+
+#define WS2812B_STORAGE WS2812B_STORAGE_RGB
+#define WS2812B_TRANSPORT WS2812B_TRANSPORT_BITBANG
+#define WS2812B_PIN_HIGH() Sim_PinHigh( )
+#define WS2812B_PIN_LOW() Sim_PinLow( )
+#define WS2812B_PIN_LOW_IF_CLEAR(byte, mask) Sim_PinLowIfClear( ( byte ), ( mask ) );
+#define WS2812B_CYCLE() Sim_Cycle( )
+
+#include "ws2812b.c"
+#include "transport_test.h"
+
+
+/****************** Macro Definition(s) *******************/
+#define BLOCK_PIXELS 4u
+
+
+/****************** Local Variable(s) *********************/
+static unsigned long simBitsSent = 0u;
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      Sim_ByteGapCycles
+ *
+ * Description:
+ *      Cycles charged before the first bit of a byte, the budget ws2812b.c asserts against for
+ *      that gap. The first byte of a frame also pays for the first pixel lookup.
+ */
+static unsigned long Sim_ByteGapCycles( const unsigned long byteIndex )
+{
+    if( 0u == byteIndex )
+    {
+        return PIXEL_BOUNDARY_OVERHEAD_CYCLES + BYTE_LOAD_CYCLES;
+    }
+    switch( byteIndex % NUM_BYTES_IN_PIXEL )
+    {
+        case 1u:
+            return GREEN_TO_RED_GAP_CYCLES;
+        case 2u:
+            return RED_TO_BLUE_GAP_CYCLES;
+        default:
+            return BLUE_TO_GREEN_GAP_CYCLES;
+    }
+}
+
+static void Sim_PinHigh( void )
+{
+    if( 0u == ( simBitsSent & 0x07u ) )
+    {
+        simCycles += Sim_ByteGapCycles( simBitsSent >> 3u );
+    }
+    if( NUM_TEST_BITS == simBitsSent )
+    {
+        dataEndCycles = simCycles;
+    }
+    Wire_Drive( SIM_CYCLES_TO_NS( simCycles ), true );
+    simCycles++;
+    simBitsSent++;
+    return;
+}
+
+static void Sim_PinLow( void )
+{
+    Wire_Drive( SIM_CYCLES_TO_NS( simCycles ), false );
+    simCycles++;
+    return;
+}
+
+static void Sim_PinLowIfClear( const uint8_t byte,
+                               const uint8_t mask )
+{
+    simCycles++; // btfss
+    if( 0u == ( byte & mask ) )
+    {
+        Wire_Drive( SIM_CYCLES_TO_NS( simCycles ), false );
+    }
+    simCycles++; // bcf, or the skipped slot
+    return;
+}
+
+static void Sim_Cycle( void )
+{
+    simCycles++;
+    return;
+}
+
+/* Function:
+ *      RecordFrame
+ *
+ * Description:
+ *      Renders the whole strip on a fresh clock and recording, then decodes it.
+ */
+static void RecordFrame( ws2812bArray * const strip,
+                         WireCapture * const capture )
+{
+    Sim_Reset( );
+    Wire_Clear( );
+    simBitsSent = 0u;
+    WS2812B_Render( strip, true );
+    Wire_Decode( &limits, capture );
+    return;
+}
+
+int main( void )
+{
+    static ws2812bPixel pixels[NUM_TEST_PIXELS];
+    static WireCapture capture;
+    bool wasSetupSuccessful;
+    ws2812bArray strip = WS2812b_Initialize( pixels, NUM_TEST_PIXELS, &wasSetupSuccessful );
+    CHECK( wasSetupSuccessful );
+    Transport_FillTestPattern( &strip );
+
+    uint8_t level;
+    for( level = 0u; level < WS2812B_NUM_BRIGHTNESS_LEVELS; level++ )
+    {
+        WS2812B_SetBrightness( &strip, level );
+        RecordFrame( &strip, &capture );
+        Transport_CheckFrame( &strip, &capture, NUM_TEST_PIXELS, resetSymbols, sizeof (resetSymbols ) );
+    }
+
+    /* The whole frame is sent with interrupts masked */
+    CHECK( Sim_GetLongestMaskedCycles( ) >= dataEndCycles );
+    CHECK( INTCONbits.GIE );
+    Transport_PrintReport( "bit bang (byte gaps charged at the ws2812b.c budgets)", &capture );
+
+    /* An unforced render skips an unchanged strip, and sends a changed one however many
+     * modifications it saw */
+    simBitsSent = 0u;
+    WS2812B_Render( &strip, false );
+    CHECK_EQUAL( simBitsSent, 0u );
+    uint16_t i;
+    for( i = 0u; i < 256u; i++ )
+    {
+        WS2812b_SetSinglePixelColor( &strip, 3u, (uint8_t) i, 0x00u, 0x00u );
+    }
+    WS2812B_Render( &strip, false );
+    CHECK( simBitsSent > NUM_TEST_BITS );
+
+    /* A dirty prefix render sends exactly the pixels up to the last modified one */
+    WS2812b_SetSinglePixelColor( &strip, DIRTY_PREFIX_PIXEL, 0x12u, 0x34u, 0x56u );
+    Sim_Reset( );
+    Wire_Clear( );
+    simBitsSent = 0u;
+    WS2812B_RenderDirtyPrefix( &strip );
+    Wire_Decode( &limits, &capture );
+    Transport_CheckFrame( &strip, &capture, DIRTY_PREFIX_PIXEL + 1u, resetSymbols, sizeof (resetSymbols ) );
+
+    /* A block write copies every byte of its pixels, and dirties exactly those pixels */
+    const uint8_t block[BLOCK_PIXELS * NUM_BYTES_IN_PIXEL] = {
+        0x01u, 0x02u, 0x03u, 0x04u, 0x05u, 0x06u, 0x07u, 0x08u, 0x09u, 0x0Au, 0x0Bu, 0x0Cu
+    };
+    WS2812b_SetPixelBlockFromRGBArray( &strip, DIRTY_PREFIX_PIXEL, BLOCK_PIXELS, block );
+    CHECK_EQUAL( memcmp( &( pixels[DIRTY_PREFIX_PIXEL] ), block, sizeof (block ) ), 0 );
+    CHECK_EQUAL( strip.dirtyStartIndex, DIRTY_PREFIX_PIXEL );
+    CHECK_EQUAL( strip.dirtyEndIndex, DIRTY_PREFIX_PIXEL + BLOCK_PIXELS );
+    Sim_Reset( );
+    Wire_Clear( );
+    simBitsSent = 0u;
+    WS2812B_RenderDirtyPrefix( &strip );
+    Wire_Decode( &limits, &capture );
+    Transport_CheckFrame( &strip, &capture, DIRTY_PREFIX_PIXEL + BLOCK_PIXELS, resetSymbols, sizeof (resetSymbols ) );
+
+    return HostTest_Finish( "test_ws2812b_bitbang" );
+}
+
+/* End test_ws2812b_bitbang.c source file */
@@ -0,0 +1,242 @@
+/* Filename: test_ws2812b_clc.c
+ *
+ * Description: Off-target model of the CLC transport. The data line is evaluated from the
+ *      registers the driver writes: TMR2 period from PR2, PWM5 duty from PWM5DCH/DCL, and CLC1 in
+ *      AND-OR mode from its input selects, gate sources, and polarity. SCK1 is one led bit per two
+ *      TMR2 periods, high phase first, and SDO1 holds each bit for its whole SCK period.
+ *
+ *      Every poll of SSP1STATbits.BF completes the byte in SSP1BUF. The next byte is loaded
+ *      CLC_RELOAD_CYCLES later and starts shifting on the following TMR2 match, so the byte gaps
+ *      inside a pixel are modelled rather than charged.
+ *
+ *      Decodes frames at every brightness level with the same decoder and limits as the other
+ *      transport tests. The frame must be followed by a plain latch and no further codes.
+ *
+ */
+
+/****************** SSP Model *****************************/
+#include <stdint.h>
+
+typedef struct
+{
+    unsigned BF : 1;
+} SimSspStatus;
+
+static SimSspStatus * Sim_SspPoll( void );
+
+#define SSP1STATbits ( *Sim_SspPoll( ) )
+#define WS2812B_STORAGE WS2812B_STORAGE_RGB
+#define WS2812B_TRANSPORT WS2812B_TRANSPORT_CLC
+
+#include "sim.h"
+#include "ws2812b.c"
+#include "transport_test.h"
+
+
+/****************** Macro Definition(s) *******************/
+#define CLC_BYTE_CYCLES ( 8u * 2u * CLC_TMR2_PERIOD_CYCLES )
+
+/* CLCxGLSy and CLCxPOL bits */
+#define CLC_GLS_TRUE(input) ( 0x02u << ( 2u * ( input ) ) )
+#define CLC_GLS_NEGATED(input) ( 0x01u << ( 2u * ( input ) ) )
+#define CLC_POL_OUTPUT 0x80u
+#define CLC_CON_MODE_MASK 0x07u
+#define CLC_CON_MODE_AND_OR 0x00u
+
+
+/****************** Local Variable(s) *********************/
+static SimSspStatus sspStatus = {1u};
+static unsigned long sspByteStartCycles = 0u; // When the byte now in SSP1BUF started shifting
+static unsigned long sspBytesSent = 0u;
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      Sim_ClcInput
+ *
+ * Description:
+ *      Level of the CLC data input a CLC1SELn code selects. Inputs the driver should not use read
+ *      as low.
+ */
+static bool Sim_ClcInput( const uint8_t selectCode,
+                          const bool sck,
+                          const bool sdo,
+                          const bool pwm )
+{
+    switch( selectCode )
+    {
+        case CLC_INPUT_SCK1:
+            return sck;
+        case CLC_INPUT_SDO1:
+            return sdo;
+        case CLC_INPUT_PWM5:
+            return pwm;
+        default:
+            return false;
+    }
+}
+
+/* Function:
+ *      Sim_ClcOutput
+ *
+ * Description:
+ *      CLC1OUT for the given peripheral levels: each gate ORs its selected data inputs, and AND-OR
+ *      mode outputs ( gate 1 AND gate 2 ) OR ( gate 3 AND gate 4 ).
+ */
+static bool Sim_ClcOutput( const bool sck,
+                           const bool sdo,
+                           const bool pwm )
+{
+    const uint8_t selects[4] = {CLC1SEL0, CLC1SEL1, CLC1SEL2, CLC1SEL3};
+    const uint8_t gateSources[4] = {CLC1GLS0, CLC1GLS1, CLC1GLS2, CLC1GLS3};
+    bool gates[4];
+    uint8_t gate;
+    uint8_t input;
+
+    for( gate = 0u; gate < 4u; gate++ )
+    {
+        gates[gate] = false;
+        for( input = 0u; input < 4u; input++ )
+        {
+            bool level = Sim_ClcInput( selects[input], sck, sdo, pwm );
+            if( ( ( gateSources[gate] & CLC_GLS_TRUE( input ) ) && level ) ||
+                ( ( gateSources[gate] & CLC_GLS_NEGATED( input ) ) && !level ) )
+            {
+                gates[gate] = true;
+            }
+        }
+        if( CLC1POL & ( 1u << gate ) )
+        {
+            gates[gate] = !gates[gate];
+        }
+    }
+
+    bool output = ( gates[0] && gates[1] ) || ( gates[2] && gates[3] );
+    if( CLC1POL & CLC_POL_OUTPUT )
+    {
+        output = !output;
+    }
+    return output;
+}
+
+/* Function:
+ *      Sim_SspShiftOut
+ *
+ * Description:
+ *      Puts one SPI byte through CLC1 onto the data line, one oscillator period at a time, then
+ *      advances the clock past it and the reload of the next byte.
+ */
+static void Sim_SspShiftOut( const uint8_t spiByte )
+{
+    unsigned long periodTosc = 4ul * ( PR2 + 1u );
+    unsigned long dutyTosc = ( (unsigned long) PWM5DCH << 2u ) | ( PWM5DCL >> 6u );
+    unsigned long byteTosc = 8ul * 2ul * periodTosc;
+    unsigned long t;
+
+    /* The transfer starts on the next TMR2 match */
+    sspByteStartCycles += ( PR2 + 1u - sspByteStartCycles % ( PR2 + 1u ) ) % ( PR2 + 1u );
+    for( t = 0u; t < byteTosc; t++ )
+    {
+        bool sck = ( 0u == ( t / periodTosc ) % 2u );
+        bool sdo = 0u != ( spiByte & ( 0x80u >> ( t / ( 2u * periodTosc ) ) ) );
+        bool pwm = ( t % periodTosc ) < dutyTosc;
+        Wire_Drive( SIM_CYCLES_TO_NS( sspByteStartCycles ) + t * SIM_NS_PER_CYCLE / 4u,
+                    Sim_ClcOutput( sck, sdo, pwm ) );
+    }
+    Wire_Drive( SIM_CYCLES_TO_NS( sspByteStartCycles ) + byteTosc * SIM_NS_PER_CYCLE / 4u, false );
+
+    if( simCycles < sspByteStartCycles + byteTosc / 4u )
+    {
+        simCycles = sspByteStartCycles + byteTosc / 4u;
+    }
+    sspBytesSent++;
+    if( NUM_TEST_BYTES == sspBytesSent )
+    {
+        dataEndCycles = simCycles;
+    }
+    simCycles += CLC_RELOAD_CYCLES;
+    sspByteStartCycles = simCycles;
+    return;
+}
+
+static SimSspStatus * Sim_SspPoll( void )
+{
+    Sim_SspShiftOut( SSP1BUF );
+    return &sspStatus;
+}
+
+/* Function:
+ *      RecordFrame
+ *
+ * Description:
+ *      Renders the strip on a fresh clock and recording, then decodes it. The reset waits for the
+ *      last byte itself, so there is nothing to flush.
+ */
+static void RecordFrame( ws2812bArray * const strip,
+                         WireCapture * const capture,
+                         const bool isDirtyPrefix )
+{
+    Sim_Reset( );
+    Wire_Clear( );
+    sspByteStartCycles = 0u;
+    sspBytesSent = 0u;
+    if( isDirtyPrefix )
+    {
+        WS2812B_RenderDirtyPrefix( strip );
+    }
+    else
+    {
+        WS2812B_Render( strip, true );
+    }
+    Wire_Decode( &limits, capture );
+    return;
+}
+
+/* Function:
+ *      CheckLatch
+ *
+ * Description:
+ *      The line must stay low for at least the latch time after the last code.
+ */
+static void CheckLatch( const WireCapture * const capture )
+{
+    CHECK( SIM_CYCLES_TO_NS( simCycles ) - capture->lastFallNs >= RESET_LOW_TIME_US * 1000ul );
+    return;
+}
+
+int main( void )
+{
+    static ws2812bPixel pixels[NUM_TEST_PIXELS];
+    static WireCapture capture;
+    bool wasSetupSuccessful;
+    ws2812bArray strip = WS2812b_Initialize( pixels, NUM_TEST_PIXELS, &wasSetupSuccessful );
+    CHECK( wasSetupSuccessful );
+    CHECK_EQUAL( RC2PPS, PPS_OUTPUT_CLC1OUT );
+    CHECK_EQUAL( CLC1CON & CLC_CON_MODE_MASK, CLC_CON_MODE_AND_OR );
+    Transport_FillTestPattern( &strip );
+
+    uint8_t level;
+    for( level = 0u; level < WS2812B_NUM_BRIGHTNESS_LEVELS; level++ )
+    {
+        WS2812B_SetBrightness( &strip, level );
+        RecordFrame( &strip, &capture, false );
+        Transport_CheckFrame( &strip, &capture, NUM_TEST_PIXELS, NULL, 0u );
+        CheckLatch( &capture );
+    }
+
+    /* Interrupts are masked while the previous blue byte and this pixel's green and red bytes
+     * shift out */
+    CHECK( Sim_GetLongestMaskedCycles( ) <= NUM_BYTES_IN_PIXEL * ( CLC_BYTE_CYCLES + CLC_MAX_BYTE_GAP_CYCLES ) );
+    CHECK( INTCONbits.GIE );
+    Transport_PrintReport( "CLC (TMR2, PWM5, and CLC1 modelled from their registers)", &capture );
+
+    WS2812b_SetSinglePixelColor( &strip, DIRTY_PREFIX_PIXEL, 0x12u, 0x34u, 0x56u );
+    RecordFrame( &strip, &capture, true );
+    Transport_CheckFrame( &strip, &capture, DIRTY_PREFIX_PIXEL + 1u, NULL, 0u );
+    CheckLatch( &capture );
+
+    return HostTest_Finish( "test_ws2812b_clc" );
+}
+
+/* End test_ws2812b_clc.c source file */
@@ -0,0 +1,131 @@
+/* Filename: test_ws2812b_gamma.c
+ *
+ * Description: Host test of the gamma and brightness lookup table in ws2812b.c. Every entry is
+ *      recomputed from the formula documented above the table, every row must be monotonic, and
+ *      changing the brightness must not touch the pixel buffers. Prints the per byte cycle budget
+ *      the lookup adds to the bit bang transport and what it costs per frame.
+ *
+ *      The transport tests check that the table is applied on the wire at every level.
+ *
+ */
+
+#define WS2812B_STORAGE WS2812B_STORAGE_RGB
+#define WS2812B_TRANSPORT WS2812B_TRANSPORT_BITBANG
+
+#include "ws2812b.c"
+#include "host_test.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define NUM_TEST_PIXELS 64u
+#define GAMMA_EXPONENT 2.5
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      ExpectedEntry
+ *
+ * Description:
+ *      round( 255 * ( x / 255 )^2.5 * 2^( level - 3 ) ), the documented table formula.
+ */
+static uint8_t ExpectedEntry( const uint8_t level,
+                              const uint8_t x )
+{
+    double scale = ldexp( 1.0, (int) level - (int) WS2812B_MAX_BRIGHTNESS_LEVEL );
+    return (uint8_t) lround( 255.0 * pow( x / 255.0, GAMMA_EXPONENT ) * scale );
+}
+
+/* Function:
+ *      CheckTable
+ *
+ * Description:
+ *      Every entry must match the formula, and every row must be non decreasing, start at 0, and
+ *      end at its brightness fraction of 255.
+ */
+static void CheckTable( void )
+{
+    uint8_t level;
+    uint16_t x;
+    for( level = 0u; level < WS2812B_NUM_BRIGHTNESS_LEVELS; level++ )
+    {
+        const uint8_t * row = gammaBrightnessLut[level];
+        for( x = 0u; x < GAMMA_LUT_SIZE; x++ )
+        {
+            CHECK_EQUAL( row[x], ExpectedEntry( level, (uint8_t) x ) );
+            if( x > 0u )
+            {
+                CHECK( row[x] >= row[x - 1u] );
+            }
+        }
+        CHECK_EQUAL( row[0], 0u );
+        CHECK_EQUAL( row[GAMMA_LUT_SIZE - 1u], ( 255u + ( 1u << ( WS2812B_MAX_BRIGHTNESS_LEVEL - level ) ) / 2u ) >> ( WS2812B_MAX_BRIGHTNESS_LEVEL - level ) );
+    }
+    return;
+}
+
+/* Function:
+ *      CheckSetBrightness
+ *
+ * Description:
+ *      A brightness change only selects a row and marks the whole strip for the next render. The
+ *      buffers keep their full brightness colors, and out of range levels are ignored.
+ */
+static void CheckSetBrightness( void )
+{
+    static ws2812bPixel pixels[NUM_TEST_PIXELS];
+    static ws2812bPixel before[NUM_TEST_PIXELS];
+    bool wasSetupSuccessful;
+    size_t i;
+
+    ws2812bArray strip = WS2812b_Initialize( pixels, NUM_TEST_PIXELS, &wasSetupSuccessful );
+    CHECK( wasSetupSuccessful );
+    CHECK_EQUAL( strip.brightnessLevel, WS2812B_MAX_BRIGHTNESS_LEVEL );
+    for( i = 0u; i < NUM_TEST_PIXELS; i++ )
+    {
+        WS2812b_SetSinglePixelColor( &strip, i, (uint8_t) ( i * 4u ), (uint8_t) ( 255u - i ), (uint8_t) ( i * 3u ) );
+    }
+    WS2812B_Render( &strip, true );
+    memcpy( before, pixels, sizeof (pixels ) );
+
+    WS2812B_SetBrightness( &strip, 1u );
+    CHECK_EQUAL( strip.brightnessLevel, 1u );
+    CHECK_EQUAL( strip.dirtyStartIndex, 0u );
+    CHECK_EQUAL( strip.dirtyEndIndex, NUM_TEST_PIXELS );
+    CHECK_EQUAL( memcmp( before, pixels, sizeof (pixels ) ), 0 );
+
+    WS2812B_Render( &strip, false );
+    WS2812B_SetBrightness( &strip, 1u );
+    CHECK_EQUAL( strip.dirtyStartIndex, strip.dirtyEndIndex );
+    WS2812B_SetBrightness( &strip, WS2812B_NUM_BRIGHTNESS_LEVELS );
+    CHECK_EQUAL( strip.brightnessLevel, 1u );
+    CHECK_EQUAL( strip.dirtyStartIndex, strip.dirtyEndIndex );
+    return;
+}
+
+int main( void )
+{
+    CheckTable( );
+    CheckSetBrightness( );
+
+    /* Every byte of a bit bang frame pays one lookup in the gap before it */
+    unsigned long lutCyclesPerFrame = (unsigned long) NUM_TEST_PIXELS * NUM_BYTES_IN_PIXEL * GAMMA_LUT_LOOKUP_CYCLES;
+    unsigned long maxGapCycles = ( WS2812B_MAX_LOW_NS - 1u ) / NS_PER_INSTRUCTION_CYCLE - WRITE_ZERO_LOW_CYCLES;
+    CHECK( GREEN_TO_RED_GAP_CYCLES <= maxGapCycles );
+    CHECK( RED_TO_BLUE_GAP_CYCLES <= maxGapCycles );
+    CHECK( BLUE_TO_GREEN_GAP_CYCLES <= maxGapCycles );
+    printf( "gamma and brightness lookup, %u levels of %u entries\n", WS2812B_NUM_BRIGHTNESS_LEVELS, GAMMA_LUT_SIZE );
+    printf( "  table size            : %u bytes of flash\n", (unsigned) sizeof (gammaBrightnessLut ) );
+    printf( "  lookup budget         : %u cycles per byte, %lu cycles (%lu us) per %u pixel frame\n",
+            GAMMA_LUT_LOOKUP_CYCLES, lutCyclesPerFrame, lutCyclesPerFrame * NS_PER_INSTRUCTION_CYCLE / 1000u,
+            NUM_TEST_PIXELS );
+    printf( "  byte gap budgets      : %u / %u / %u cycles (green to red / red to blue / blue to green), limit %lu\n",
+            GREEN_TO_RED_GAP_CYCLES, RED_TO_BLUE_GAP_CYCLES, BLUE_TO_GREEN_GAP_CYCLES, maxGapCycles );
+
+    return HostTest_Finish( "test_ws2812b_gamma" );
+}
+
+/* End test_ws2812b_gamma.c source file */
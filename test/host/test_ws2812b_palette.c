@@ -0,0 +1,293 @@
+/* Filename: test_ws2812b_palette.c
+ *
+ * Description: Host test of the palette storage in ws2812b.c, built with the bit bang transport and
+ *      its conditional pin drop replaced by a recorder of the bit each WRITE_BIT sends.
+ *
+ *      Every pixel of an odd length strip is pointed at a palette entry one at a time, and the
+ *      recorded frame must be each pixel's entry, gamma corrected, in wire order. Writing one pixel
+ *      of a byte must leave the other alone. A palette write must only mark the strip, and out of
+ *      range pixels, blocks, and palette entries must be ignored. Glyph writes must mark only a
+ *      changed block. A double buffered strip must carry an odd dirty range across a flip. Prints
+ *      the buffer RAM against RGB storage.
+ *
+ */
+
+/****************** Recorder Primitive(s) *****************/
+#include <stdint.h>
+
+static void Palette_RecordBit( const uint8_t byte,
+                               const uint8_t mask );
+
+#define WS2812B_STORAGE WS2812B_STORAGE_PALETTE
+#define WS2812B_TRANSPORT WS2812B_TRANSPORT_BITBANG
+#define WS2812B_PIN_HIGH()
+#define WS2812B_PIN_LOW()
+#define WS2812B_PIN_LOW_IF_CLEAR(byte, mask) Palette_RecordBit( ( byte ), ( mask ) );
+#define WS2812B_CYCLE()
+
+#include "ws2812b.c"
+#include "host_test.h"
+#include <stdio.h>
+#include <string.h>
+
+
+/****************** Macro Definition(s) *******************/
+#define NUM_TEST_PIXELS 63u // Odd, so the last byte holds a single pixel
+#define NUM_TEST_BYTES ( NUM_TEST_PIXELS * NUM_BYTES_IN_PIXEL )
+#define GLYPH_START_PIXEL 51u
+#define GLYPH_NUM_PIXELS 12u
+#define GLYPH_BITMASK 0xB5A0u
+#define FLIP_START_PIXEL 5u // Odd start and end, so both end bytes are shared with clean pixels
+#define FLIP_NUM_PIXELS 4u
+
+
+/****************** Local Variable(s) *********************/
+static uint8_t wireBytes[NUM_TEST_BYTES];
+static size_t numBitsRecorded = 0u;
+
+
+/*********************** Function(s) **********************/
+
+static void Palette_RecordBit( const uint8_t byte,
+                               const uint8_t mask )
+{
+    size_t byteIndex = numBitsRecorded / 8u;
+    if( byteIndex < NUM_TEST_BYTES )
+    {
+        wireBytes[byteIndex] = (uint8_t) ( ( wireBytes[byteIndex] << 1u ) | ( ( byte & mask ) ? 1u : 0u ) );
+    }
+    numBitsRecorded++;
+    return;
+}
+
+/* Function:
+ *      EntryFor
+ *
+ * Description:
+ *      Palette entry the fill pattern gives a pixel. Neighbours always differ.
+ */
+static uint8_t EntryFor( const size_t pixel )
+{
+    return (uint8_t) ( ( pixel * 7u + 3u ) % WS2812B_PALETTE_SIZE );
+}
+
+/* Function:
+ *      IndexAt
+ *
+ * Description:
+ *      A pixel's palette index, read straight from an index buffer.
+ */
+static uint8_t IndexAt( const ws2812bStorage * const indices,
+                        const size_t pixel )
+{
+    uint8_t packed = indices[pixel / 2u];
+    return ( 0u == ( pixel % 2u ) ) ? ( packed >> 4u ) : ( packed & 0x0Fu );
+}
+
+/* Function:
+ *      FillPalette
+ *
+ * Description:
+ *      A distinct color per entry, including the all zero and all one bytes.
+ */
+static void FillPalette( ws2812bArray * const strip )
+{
+    uint8_t entry;
+    for( entry = 0u; entry < WS2812B_PALETTE_SIZE; entry++ )
+    {
+        WS2812b_SetPaletteColor( strip, entry, (uint8_t) ( entry * 17u ), (uint8_t) ( 0xFFu - entry * 13u ), (uint8_t) ( entry * 5u + 1u ) );
+    }
+    WS2812b_SetPaletteColor( strip, 0u, 0x00u, 0x00u, 0x00u );
+    WS2812b_SetPaletteColor( strip, 1u, 0xFFu, 0xFFu, 0xFFu );
+    return;
+}
+
+/* Function:
+ *      CheckWire
+ *
+ * Description:
+ *      Renders the strip and checks the recorded frame against each pixel's palette entry.
+ */
+static void CheckWire( ws2812bArray * const strip,
+                       const uint8_t * const entries )
+{
+    const uint8_t * gammaLut = gammaBrightnessLut[strip->brightnessLevel];
+    size_t i;
+
+    numBitsRecorded = 0u;
+    WS2812B_Render( strip, true );
+    CHECK_EQUAL( numBitsRecorded, NUM_TEST_BYTES * 8u );
+    for( i = 0u; i < NUM_TEST_PIXELS; i++ )
+    {
+        const ws2812bPixel * color = &( strip->palette[entries[i]] );
+        CHECK_EQUAL( wireBytes[i * NUM_BYTES_IN_PIXEL], gammaLut[color->green] );
+        CHECK_EQUAL( wireBytes[i * NUM_BYTES_IN_PIXEL + 1u], gammaLut[color->red] );
+        CHECK_EQUAL( wireBytes[i * NUM_BYTES_IN_PIXEL + 2u], gammaLut[color->blue] );
+    }
+    return;
+}
+
+/* Function:
+ *      CheckDirty
+ *
+ * Description:
+ *      The strip's dirty range must be [start, end), then the range is cleared.
+ */
+static void CheckDirty( ws2812bArray * const strip,
+                        const size_t start,
+                        const size_t end )
+{
+    CHECK_EQUAL( strip->dirtyStartIndex, start );
+    CHECK_EQUAL( strip->dirtyEndIndex, end );
+    strip->dirtyStartIndex = 0u;
+    strip->dirtyEndIndex = 0u;
+    return;
+}
+
+/* Function:
+ *      CheckSingleBuffered
+ *
+ * Description:
+ *      Index writes, palette writes, glyph writes, and the argument checks on a single buffered
+ *      strip.
+ */
+static void CheckSingleBuffered( void )
+{
+    static ws2812bStorage indices[WS2812B_STORAGE_SIZE( NUM_TEST_PIXELS )];
+    uint8_t entries[NUM_TEST_PIXELS] = {0u};
+    bool wasSetupSuccessful;
+    size_t i;
+
+    ws2812bArray strip = WS2812b_Initialize( indices, NUM_TEST_PIXELS, &wasSetupSuccessful );
+    CHECK( wasSetupSuccessful );
+    for( i = 0u; i < WS2812B_PALETTE_SIZE; i++ )
+    {
+        CHECK( ( 0u == strip.palette[i].red ) && ( 0u == strip.palette[i].green ) && ( 0u == strip.palette[i].blue ) );
+    }
+    FillPalette( &strip );
+    CheckDirty( &strip, 0u, NUM_TEST_PIXELS );
+
+    /* One pixel at a time, each write marking only its pixel and leaving its byte neighbour. The
+     * buffer starts at entry 0, so writing entry 0 marks nothing. */
+    for( i = 0u; i < NUM_TEST_PIXELS; i++ )
+    {
+        WS2812b_SetSinglePixelPaletteIndex( &strip, i, EntryFor( i ) );
+        entries[i] = EntryFor( i );
+        if( 0u == entries[i] )
+        {
+            CheckDirty( &strip, 0u, 0u );
+        }
+        else
+        {
+            CheckDirty( &strip, i, i + 1u );
+        }
+        CHECK_EQUAL( IndexAt( indices, i ), entries[i] );
+        if( i > 0u )
+        {
+            CHECK_EQUAL( IndexAt( indices, i - 1u ), entries[i - 1u] );
+        }
+    }
+    CheckWire( &strip, entries );
+
+    /* Rewriting the same entry changes nothing */
+    WS2812b_SetSinglePixelPaletteIndex( &strip, 10u, entries[10] );
+    WS2812b_SetPaletteColor( &strip, 4u, strip.palette[4].red, strip.palette[4].green, strip.palette[4].blue );
+    CheckDirty( &strip, 0u, 0u );
+
+    /* A palette write recolors every pixel using the entry without touching an index */
+    uint8_t before[sizeof (indices )];
+    memcpy( before, indices, sizeof (indices ) );
+    WS2812b_SetPaletteColor( &strip, entries[20], 0x12u, 0x34u, 0x56u );
+    CHECK( 0 == memcmp( before, indices, sizeof (indices ) ) );
+    CheckDirty( &strip, 0u, NUM_TEST_PIXELS );
+    CheckWire( &strip, entries );
+
+    /* Out of range arguments are ignored */
+    WS2812b_SetSinglePixelPaletteIndex( &strip, NUM_TEST_PIXELS, 0u );
+    WS2812b_SetSinglePixelPaletteIndex( &strip, 0u, WS2812B_PALETTE_SIZE );
+    WS2812b_SetPixelBlockPaletteIndex( &strip, NUM_TEST_PIXELS - 2u, 3u, 0u );
+    WS2812b_SetPixelBlockFromBitmaskPaletteIndex( &strip, 0u, 17u, 0xFFFFu, 0u, 1u );
+    WS2812b_SetPixelBlockFromBitmaskPaletteIndex( &strip, 0u, 4u, 0xFFFFu, WS2812B_PALETTE_SIZE, 1u );
+    WS2812b_SetPaletteColor( &strip, WS2812B_PALETTE_SIZE, 0u, 0u, 0u );
+    CHECK( 0 == memcmp( before, indices, sizeof (indices ) ) );
+    CheckDirty( &strip, 0u, 0u );
+
+    /* A glyph at an odd start, marked only when it changes something */
+    WS2812b_SetPixelBlockFromBitmaskPaletteIndex( &strip, GLYPH_START_PIXEL, GLYPH_NUM_PIXELS, GLYPH_BITMASK, 1u, 2u );
+    for( i = 0u; i < GLYPH_NUM_PIXELS; i++ )
+    {
+        entries[GLYPH_START_PIXEL + i] = ( GLYPH_BITMASK & ( BITMASK_MSB >> i ) ) ? 1u : 2u;
+    }
+    CheckDirty( &strip, GLYPH_START_PIXEL, GLYPH_START_PIXEL + GLYPH_NUM_PIXELS );
+    WS2812b_SetPixelBlockFromBitmaskPaletteIndex( &strip, GLYPH_START_PIXEL, GLYPH_NUM_PIXELS, GLYPH_BITMASK, 1u, 2u );
+    CheckDirty( &strip, 0u, 0u );
+    CheckWire( &strip, entries );
+
+    /* The whole strip, including the lone pixel in the last byte */
+    WS2812b_SetStripPaletteIndex( &strip, 1u );
+    memset( entries, 1, sizeof (entries ) );
+    CheckDirty( &strip, 0u, NUM_TEST_PIXELS );
+    CheckWire( &strip, entries );
+    return;
+}
+
+/* Function:
+ *      CheckDoubleBuffered
+ *
+ * Description:
+ *      Composes an odd range into the back buffer of a dirty copy strip. The front buffer must not
+ *      change until the flip, and after it both buffers must hold the composed frame.
+ */
+static void CheckDoubleBuffered( void )
+{
+    static ws2812bStorage backIndices[WS2812B_STORAGE_SIZE( NUM_TEST_PIXELS )];
+    static ws2812bStorage frontIndices[WS2812B_STORAGE_SIZE( NUM_TEST_PIXELS )];
+    uint8_t entries[NUM_TEST_PIXELS] = {0u};
+    bool wasSetupSuccessful;
+    size_t i;
+
+    ws2812bArray strip = WS2812b_InitializeDoubleBuffered( backIndices, frontIndices, NUM_TEST_PIXELS,
+                                                           WS2812B_FLIP_COPY_DIRTY, &wasSetupSuccessful );
+    CHECK( wasSetupSuccessful );
+    FillPalette( &strip );
+    for( i = 0u; i < NUM_TEST_PIXELS; i++ )
+    {
+        WS2812b_SetSinglePixelPaletteIndex( &strip, i, EntryFor( i ) );
+        entries[i] = EntryFor( i );
+    }
+    WS2812B_FlipBuffers( &strip );
+    CheckWire( &strip, entries );
+    CHECK( 0 == memcmp( backIndices, frontIndices, sizeof (backIndices ) ) );
+
+    WS2812b_SetPixelBlockPaletteIndex( &strip, FLIP_START_PIXEL, FLIP_NUM_PIXELS, 1u );
+    CHECK_EQUAL( strip.backDirtyStartIndex, FLIP_START_PIXEL );
+    CHECK_EQUAL( strip.backDirtyEndIndex, FLIP_START_PIXEL + FLIP_NUM_PIXELS );
+    CheckWire( &strip, entries );
+
+    for( i = FLIP_START_PIXEL; i < FLIP_START_PIXEL + FLIP_NUM_PIXELS; i++ )
+    {
+        entries[i] = 1u;
+    }
+    WS2812B_FlipBuffers( &strip );
+    CHECK( 0 == memcmp( backIndices, frontIndices, sizeof (backIndices ) ) );
+    CHECK_EQUAL( strip.dirtyStartIndex, FLIP_START_PIXEL );
+    CHECK_EQUAL( strip.dirtyEndIndex, FLIP_START_PIXEL + FLIP_NUM_PIXELS );
+    CheckWire( &strip, entries );
+    return;
+}
+
+int main( void )
+{
+    CheckSingleBuffered( );
+    CheckDoubleBuffered( );
+
+    printf( "palette storage, %u entries\n", WS2812B_PALETTE_SIZE );
+    printf( "  64 pixel buffer       : %u bytes of indices plus the %u byte palette, %u bytes as RGB\n",
+            (unsigned) ( WS2812B_STORAGE_SIZE( 64u ) * sizeof (ws2812bStorage ) ),
+            (unsigned) sizeof (( (ws2812bArray *) NULL )->palette ),
+            (unsigned) ( 64u * sizeof (ws2812bPixel ) ) );
+
+    return HostTest_Finish( "test_ws2812b_palette" );
+}
+
+/* End test_ws2812b_palette.c source file */
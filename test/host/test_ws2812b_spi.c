@@ -0,0 +1,165 @@
+/* Filename: test_ws2812b_spi.c
+ *
+ * Description: Off-target model of the SPI transport. Every poll of SSP1STATbits.BF completes the
+ *      byte in SSP1BUF: its 8 SPI bits are put on the recorded data line, SPI_CYCLES_PER_SYMBOL_BIT
+ *      cycles each, and the simulated clock moves on to the end of the byte plus the
+ *      SPI_MAX_BYTE_GAP_CYCLES the driver allows for the poll and reload. The CPU work between two
+ *      writes is assumed to fit in the 24 cycles the previous byte takes to shift out.
+ *
+ *      Checks the symbol table, then decodes frames at every brightness level with the same
+ *      decoder, limits, and expected reset codes as the bit bang test, so both transports put
+ *      identical frames on the wire.
+ *
+ */
+
+/****************** SSP Model *****************************/
+#include <stdint.h>
+
+typedef struct
+{
+    unsigned BF : 1;
+} SimSspStatus;
+
+static SimSspStatus * Sim_SspPoll( void );
+
+#define SSP1STATbits ( *Sim_SspPoll( ) )
+#define WS2812B_STORAGE WS2812B_STORAGE_RGB
+#define WS2812B_TRANSPORT WS2812B_TRANSPORT_SPI
+
+#include "sim.h"
+#include "ws2812b.c"
+#include "transport_test.h"
+
+
+/****************** Macro Definition(s) *******************/
+#define SPI_BYTE_CYCLES ( 8u * SPI_CYCLES_PER_SYMBOL_BIT )
+#define SPI_BYTES_PER_LED_BYTE 4u
+
+
+/****************** Local Variable(s) *********************/
+static SimSspStatus sspStatus = {1u};
+static unsigned long sspByteStartCycles = 0u; // When the byte now in SSP1BUF started shifting
+static unsigned long sspBytesSent = 0u;
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      Sim_SspShiftOut
+ *
+ * Description:
+ *      Puts one SPI byte on the data line, MSB first, then advances the clock past it and the
+ *      reload gap.
+ */
+static void Sim_SspShiftOut( const uint8_t spiByte )
+{
+    uint8_t bit;
+    for( bit = 0u; bit < 8u; bit++ )
+    {
+        Wire_Drive( SIM_CYCLES_TO_NS( sspByteStartCycles + bit * SPI_CYCLES_PER_SYMBOL_BIT ),
+                    0u != ( spiByte & ( 0x80u >> bit ) ) );
+    }
+
+    /* The priming byte plus 4 SPI bytes per led byte, then the reset */
+    if( 1u + NUM_TEST_BYTES * SPI_BYTES_PER_LED_BYTE == sspBytesSent )
+    {
+        dataEndCycles = sspByteStartCycles;
+    }
+    sspBytesSent++;
+
+    if( simCycles < sspByteStartCycles + SPI_BYTE_CYCLES )
+    {
+        simCycles = sspByteStartCycles + SPI_BYTE_CYCLES;
+    }
+    simCycles += SPI_MAX_BYTE_GAP_CYCLES;
+    sspByteStartCycles = simCycles;
+    return;
+}
+
+static SimSspStatus * Sim_SspPoll( void )
+{
+    Sim_SspShiftOut( SSP1BUF );
+    return &sspStatus;
+}
+
+/* Function:
+ *      RecordFrame
+ *
+ * Description:
+ *      Renders the whole strip on a fresh clock and recording, flushes the last SPI byte, then
+ *      decodes the recording.
+ */
+static void RecordFrame( ws2812bArray * const strip,
+                         WireCapture * const capture,
+                         const bool isDirtyPrefix )
+{
+    Sim_Reset( );
+    Wire_Clear( );
+    sspByteStartCycles = 0u;
+    sspBytesSent = 0u;
+    if( isDirtyPrefix )
+    {
+        WS2812B_RenderDirtyPrefix( strip );
+    }
+    else
+    {
+        WS2812B_Render( strip, true );
+    }
+    Sim_SspShiftOut( SSP1BUF );
+    Wire_Decode( &limits, capture );
+    return;
+}
+
+/* Function:
+ *      CheckSymbolTable
+ *
+ * Description:
+ *      Every SPI byte must be two 4 bit symbols, 1100 for a 1 code and 1000 for a 0 code, in the
+ *      order of the two led bits that index it.
+ */
+static void CheckSymbolTable( void )
+{
+    uint8_t pair;
+    for( pair = 0u; pair < 4u; pair++ )
+    {
+        uint8_t firstSymbol = ( pair & 0x02u ) ? 0x0Cu : 0x08u;
+        uint8_t secondSymbol = ( pair & 0x01u ) ? 0x0Cu : 0x08u;
+        CHECK_EQUAL( spiSymbolPairs[pair], ( firstSymbol << 4u ) | secondSymbol );
+    }
+    CHECK_EQUAL( SPI_RESET_ONE_ZERO_SYMBOLS, 0xC8u );
+    CHECK_EQUAL( SPI_RESET_ONE_SYMBOL, 0xC0u );
+    return;
+}
+
+int main( void )
+{
+    static ws2812bPixel pixels[NUM_TEST_PIXELS];
+    static WireCapture capture;
+    bool wasSetupSuccessful;
+    ws2812bArray strip = WS2812b_Initialize( pixels, NUM_TEST_PIXELS, &wasSetupSuccessful );
+    CHECK( wasSetupSuccessful );
+    CHECK_EQUAL( RC2PPS, PPS_OUTPUT_SDO1 );
+    CheckSymbolTable( );
+    Transport_FillTestPattern( &strip );
+
+    uint8_t level;
+    for( level = 0u; level < WS2812B_NUM_BRIGHTNESS_LEVELS; level++ )
+    {
+        WS2812B_SetBrightness( &strip, level );
+        RecordFrame( &strip, &capture, false );
+        Transport_CheckFrame( &strip, &capture, NUM_TEST_PIXELS, resetSymbols, sizeof (resetSymbols ) );
+    }
+
+    /* Interrupts are only masked for one pixel: 12 SPI bytes and their reload gaps */
+    CHECK( Sim_GetLongestMaskedCycles( ) <= NUM_BYTES_IN_PIXEL * SPI_BYTES_PER_LED_BYTE * ( SPI_BYTE_CYCLES + SPI_MAX_BYTE_GAP_CYCLES ) );
+    CHECK( INTCONbits.GIE );
+    Transport_PrintReport( "SPI (reload gaps charged at SPI_MAX_BYTE_GAP_CYCLES)", &capture );
+
+    WS2812b_SetSinglePixelColor( &strip, DIRTY_PREFIX_PIXEL, 0x12u, 0x34u, 0x56u );
+    RecordFrame( &strip, &capture, true );
+    Transport_CheckFrame( &strip, &capture, DIRTY_PREFIX_PIXEL + 1u, resetSymbols, sizeof (resetSymbols ) );
+
+    return HostTest_Finish( "test_ws2812b_spi" );
+}
+
+/* End test_ws2812b_spi.c source file */
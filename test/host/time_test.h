@@ -0,0 +1,109 @@
+/* Filename: time_test.h
+ *
+ * Description: Stand ins for the modules timeCalculation.c calls, shared by the time tests. The
+ *      EEPROM is a RAM array, the encoder returns whatever the test queued, and the display only
+ *      records the digits it was asked to render. Include after timeCalculation.c and tmr5.c.
+ *
+ */
+
+#ifndef TIME_TEST_H
+#define TIME_TEST_H
+
+#include "host_test.h"
+#include <string.h>
+
+/****************** Macro Definition(s) *******************/
+#define TEST_EEPROM_SIZE 0x100u
+#define TEST_EEPROM_ADDR_MASK 0xFFu
+#define SECONDS_PER_12_HOURS ( 12ul * 3600ul )
+
+
+/****************** Local Variable(s) *********************/
+static uint8_t testEeprom[TEST_EEPROM_SIZE];
+static int32_t testShaftCounts = 0; // Returned, then cleared, by the next RotaryEncoder_GetShaftCounts
+static TimeInDigits lastRenderedDigits;
+static unsigned long numRenders = 0u;
+
+
+/*********************** Function(s) **********************/
+
+uint8_t DATAEE_ReadByte( uint16_t bAdd )
+{
+    return testEeprom[bAdd & TEST_EEPROM_ADDR_MASK];
+}
+
+void DATAEE_WriteByte( uint16_t bAdd,
+                       uint8_t bData )
+{
+    testEeprom[bAdd & TEST_EEPROM_ADDR_MASK] = bData;
+    return;
+}
+
+int32_t RotaryEncoder_GetShaftCounts( void )
+{
+    int32_t counts = testShaftCounts;
+    testShaftCounts = 0;
+    return counts;
+}
+
+void Clock_WriteTimeDigitValuesAndRenderScreen( const TimeInDigits * const digits )
+{
+    lastRenderedDigits = *digits;
+    numRenders++;
+    return;
+}
+
+/* Function:
+ *      TimeTest_ExpectedBcd
+ *
+ * Description:
+ *      Reference conversion of seconds since 1:00:00 into the module's packed BCD time, by plain
+ *      division.
+ */
+static BcdTime TimeTest_ExpectedBcd( const unsigned long secondsSinceOne )
+{
+    unsigned long seconds = secondsSinceOne % SECONDS_PER_12_HOURS;
+    unsigned long hours = seconds / 3600u + 1u;
+    unsigned long minutes = ( seconds / 60u ) % 60u;
+    BcdTime t = {
+        .hours = (uint8_t) ( ( ( hours / 10u ) << 4u ) | ( hours % 10u ) ),
+        .minutes = (uint8_t) ( ( ( minutes / 10u ) << 4u ) | ( minutes % 10u ) ),
+        .seconds = (uint8_t) ( ( ( seconds % 60u / 10u ) << 4u ) | ( seconds % 10u ) )
+    };
+    return t;
+}
+
+/* Function:
+ *      TimeTest_CheckTime
+ *
+ * Description:
+ *      The ISR's time must equal the reference for the given seconds since 1:00:00.
+ */
+static void TimeTest_CheckTime( const unsigned long secondsSinceOne )
+{
+    BcdTime expected = TimeTest_ExpectedBcd( secondsSinceOne );
+    CHECK_EQUAL( currentTime.hours, expected.hours );
+    CHECK_EQUAL( currentTime.minutes, expected.minutes );
+    CHECK_EQUAL( currentTime.seconds, expected.seconds );
+    return;
+}
+
+/* Function:
+ *      TimeTest_CheckRenderedTime
+ *
+ * Description:
+ *      The last rendered digits must show the given seconds since 1:00:00.
+ */
+static void TimeTest_CheckRenderedTime( const unsigned long secondsSinceOne )
+{
+    BcdTime expected = TimeTest_ExpectedBcd( secondsSinceOne );
+    CHECK_EQUAL( lastRenderedDigits.digit1, expected.hours >> 4u );
+    CHECK_EQUAL( lastRenderedDigits.digit2, expected.hours & 0x0Fu );
+    CHECK_EQUAL( lastRenderedDigits.digit3, expected.minutes >> 4u );
+    CHECK_EQUAL( lastRenderedDigits.digit4, expected.minutes & 0x0Fu );
+    return;
+}
+
+#endif
+
+/* End time_test.h header file */
@@ -0,0 +1,121 @@
+/* Filename: transport_test.h
+ *
+ * Description: Frame fill, check, and report shared by the transport tests, so every transport is
+ *      held to the same frame and the same checks. Include after ws2812b.c, since the checks use
+ *      its gamma table.
+ *
+ */
+
+#ifndef TRANSPORT_TEST_H
+#define TRANSPORT_TEST_H
+
+#include "host_test.h"
+#include "sim.h"
+#include "wire.h"
+
+/****************** Macro Definition(s) *******************/
+#define NUM_TEST_PIXELS 64u // One clock face
+#define NUM_TEST_BYTES ( NUM_TEST_PIXELS * NUM_BYTES_IN_PIXEL )
+#define NUM_TEST_BITS ( NUM_TEST_BYTES * 8u )
+#define DIRTY_PREFIX_PIXEL 10u
+
+
+/****************** Local Variable(s) *********************/
+static const WireLimits limits = WIRE_LIMITS_FROM_DRIVER;
+static unsigned long dataEndCycles = 0u; // Start of the first code after the frame, set by the test
+
+/* Codes after the last pixel. The bit bang and SPI transports send a 1 and a 0 code, the latch,
+ * and another 1 code. */
+static const uint8_t resetSymbols[] = {WIRE_SYMBOL_ONE, WIRE_SYMBOL_ZERO, WIRE_SYMBOL_LATCH, WIRE_SYMBOL_ONE};
+
+
+/*********************** Function(s) **********************/
+
+/* Function:
+ *      Transport_FillTestPattern
+ *
+ * Description:
+ *      Fills the strip with a fixed pseudo random pattern plus the all zero and all one bytes.
+ */
+static void Transport_FillTestPattern( ws2812bArray * const strip )
+{
+    uint32_t lcg = 12345u;
+    size_t i;
+    for( i = 0u; i < strip->numPixels; i++ )
+    {
+        lcg = lcg * 1103515245u + 12345u;
+        WS2812b_SetSinglePixelColor( strip, i, (uint8_t) ( lcg >> 8u ), (uint8_t) ( lcg >> 16u ), (uint8_t) ( lcg >> 24u ) );
+    }
+    WS2812b_SetSinglePixelColor( strip, 0u, 0x00u, 0x00u, 0x00u );
+    WS2812b_SetSinglePixelColor( strip, 1u, 0xFFu, 0xFFu, 0xFFu );
+    return;
+}
+
+/* Function:
+ *      Transport_CheckFrame
+ *
+ * Description:
+ *      Checks the decoded recording: no timing errors, the gamma corrected pixels in wire order,
+ *      then exactly the given codes after the last pixel.
+ */
+static void Transport_CheckFrame( const ws2812bArray * const strip,
+                                  const WireCapture * const capture,
+                                  const size_t numPixels,
+                                  const uint8_t * const tailSymbols,
+                                  const size_t numTailSymbols )
+{
+    static uint8_t wireBytes[NUM_TEST_BYTES];
+    const uint8_t * gammaLut = gammaBrightnessLut[strip->brightnessLevel];
+    size_t numDataBits = numPixels * NUM_BYTES_IN_PIXEL * 8u;
+    size_t i;
+
+    CHECK_EQUAL( capture->numTimingErrors, 0u );
+    (void) Wire_PackBytes( capture, wireBytes, sizeof (wireBytes ) );
+    for( i = 0u; i < numPixels; i++ )
+    {
+        const ws2812bPixel * pixel = &( strip->frontBuffer[i] );
+        CHECK_EQUAL( wireBytes[i * NUM_BYTES_IN_PIXEL], gammaLut[pixel->green] );
+        CHECK_EQUAL( wireBytes[i * NUM_BYTES_IN_PIXEL + 1u], gammaLut[pixel->red] );
+        CHECK_EQUAL( wireBytes[i * NUM_BYTES_IN_PIXEL + 2u], gammaLut[pixel->blue] );
+    }
+
+    CHECK_EQUAL( capture->numSymbols, numDataBits + numTailSymbols );
+    for( i = 0u; ( i < numTailSymbols ) && ( numDataBits + i < capture->numSymbols ); i++ )
+    {
+        CHECK_EQUAL( capture->symbols[numDataBits + i], tailSymbols[i] );
+    }
+    return;
+}
+
+/* Function:
+ *      Transport_PrintReport
+ *
+ * Description:
+ *      Prints the frame timing of the last full frame, from the simulated clock and the decoded
+ *      recording.
+ */
+static void Transport_PrintReport( const char * const transportName,
+                                   const WireCapture * const capture )
+{
+    unsigned long frameNs = SIM_CYCLES_TO_NS( dataEndCycles );
+    unsigned long totalNs = SIM_CYCLES_TO_NS( simCycles );
+    unsigned long maskedCycles = Sim_GetLongestMaskedCycles( );
+
+    printf( "%s, %u pixels\n", transportName, NUM_TEST_PIXELS );
+    printf( "  cycles per frame      : %lu (%lu per bit)\n", dataEndCycles, dataEndCycles / NUM_TEST_BITS );
+    printf( "  frame time            : %lu.%03lu us, %lu.%03lu us with reset\n",
+            frameNs / 1000u, frameNs % 1000u, totalNs / 1000u, totalNs % 1000u );
+    printf( "  bit rate              : %lu bit/s\n",
+            (unsigned long) ( (unsigned long long) NUM_TEST_BITS * 1000000000ull / frameNs ) );
+    printf( "  longest masked window : %lu cycles, %lu.%03lu us\n", maskedCycles,
+            SIM_CYCLES_TO_NS( maskedCycles ) / 1000u, SIM_CYCLES_TO_NS( maskedCycles ) % 1000u );
+    printf( "  1 code high / low     : %lu-%lu / %lu-%lu ns\n", capture->minOneHighNs, capture->maxOneHighNs,
+            capture->minOneLowNs, capture->maxOneLowNs );
+    printf( "  0 code high / low     : %lu-%lu / %lu-%lu ns\n", capture->minZeroHighNs, capture->maxZeroHighNs,
+            capture->minZeroLowNs, capture->maxZeroLowNs );
+    return;
+}
+
+#endif
+
+/* End transport_test.h header file */
@@ -0,0 +1,214 @@
+/* Filename: wire.c
+ *
+ * Description: Data line recorder and WS2812B decoder, see wire.h.
+ *
+ */
+
+#include "wire.h"
+#include <stdio.h>
+#include <string.h>
+
+/****************** Macro Definition(s) *******************/
+#define WIRE_MAX_PRINTED_ERRORS 10u
+
+
+/****************** Type Definition(s) ********************/
+typedef struct
+{
+    unsigned long timeNs;
+    bool level;
+} WireEdge;
+
+
+/****************** Local Variable(s) *********************/
+static WireEdge edges[WIRE_MAX_EDGES];
+static size_t numEdges = 0u;
+static bool lineLevel = false;
+
+
+/****************** Static Function Prototype(s) **********/
+static void Wire_TimingError( WireCapture * const capture,
+                              const unsigned long timeNs,
+                              const char * const what,
+                              const unsigned long ns );
+static void Wire_TrackRange( unsigned long * const minNs,
+                             unsigned long * const maxNs,
+                             const unsigned long ns );
+
+
+/*********************** Function(s) **********************/
+
+void Wire_Clear( void )
+{
+    numEdges = 0u;
+    lineLevel = false;
+    return;
+}
+
+void Wire_Drive( const unsigned long timeNs,
+                 const bool level )
+{
+    if( level == lineLevel )
+    {
+        return;
+    }
+    if( ( numEdges >= WIRE_MAX_EDGES ) ||
+        ( ( numEdges > 0u ) && ( timeNs < edges[numEdges - 1u].timeNs ) ) )
+    {
+        fprintf( stderr, "wire: edge at %lu ns dropped\n", timeNs );
+        return;
+    }
+    edges[numEdges].timeNs = timeNs;
+    edges[numEdges].level = level;
+    numEdges++;
+    lineLevel = level;
+    return;
+}
+
+void Wire_Decode( const WireLimits * const limits,
+                  WireCapture * const capture )
+{
+    memset( capture, 0, sizeof (*capture ) );
+    capture->minOneHighNs = ~0ul;
+    capture->minZeroHighNs = ~0ul;
+    capture->minOneLowNs = ~0ul;
+    capture->minZeroLowNs = ~0ul;
+    if( numEdges > 0u )
+    {
+        capture->firstRiseNs = edges[0].timeNs;
+    }
+
+    size_t i;
+    for( i = 0u; i + 1u < numEdges; i += 2u )
+    {
+        unsigned long riseNs = edges[i].timeNs;
+        unsigned long fallNs = edges[i + 1u].timeNs;
+        unsigned long highNs = fallNs - riseNs;
+        bool isOne;
+
+        capture->lastFallNs = fallNs;
+
+        if( ( highNs >= limits->oneHighNs - limits->toleranceNs ) &&
+            ( highNs <= limits->oneHighNs + limits->toleranceNs ) )
+        {
+            isOne = true;
+            Wire_TrackRange( &( capture->minOneHighNs ), &( capture->maxOneHighNs ), highNs );
+        }
+        else if( ( highNs >= limits->zeroHighNs - limits->toleranceNs ) &&
+                 ( highNs <= limits->zeroHighNs + limits->toleranceNs ) )
+        {
+            isOne = false;
+            Wire_TrackRange( &( capture->minZeroHighNs ), &( capture->maxZeroHighNs ), highNs );
+        }
+        else
+        {
+            Wire_TimingError( capture, riseNs, "high time fits neither code", highNs );
+            continue;
+        }
+
+        if( capture->numSymbols < WIRE_MAX_SYMBOLS )
+        {
+            capture->symbols[capture->numSymbols++] = isOne ? WIRE_SYMBOL_ONE : WIRE_SYMBOL_ZERO;
+        }
+
+        /* The final low runs on indefinitely, so there is nothing to check */
+        if( i + 2u >= numEdges )
+        {
+            break;
+        }
+
+        unsigned long lowNs = edges[i + 2u].timeNs - fallNs;
+        if( lowNs >= limits->latchNs )
+        {
+            if( 0u == capture->firstLatchNs )
+            {
+                capture->firstLatchNs = fallNs;
+            }
+            if( capture->numSymbols < WIRE_MAX_SYMBOLS )
+            {
+                capture->symbols[capture->numSymbols++] = WIRE_SYMBOL_LATCH;
+            }
+            continue;
+        }
+
+        if( lowNs >= limits->maxLowNs )
+        {
+            Wire_TimingError( capture, fallNs, "low time risks a latch", lowNs );
+        }
+        if( isOne )
+        {
+            if( lowNs < limits->oneLowNs - limits->toleranceNs )
+            {
+                Wire_TimingError( capture, fallNs, "1 code low time too short", lowNs );
+            }
+            Wire_TrackRange( &( capture->minOneLowNs ), &( capture->maxOneLowNs ), lowNs );
+        }
+        else
+        {
+            if( lowNs < limits->zeroLowNs - limits->toleranceNs )
+            {
+                Wire_TimingError( capture, fallNs, "0 code low time too short", lowNs );
+            }
+            Wire_TrackRange( &( capture->minZeroLowNs ), &( capture->maxZeroLowNs ), lowNs );
+        }
+    }
+    return;
+}
+
+size_t Wire_PackBytes( const WireCapture * const capture,
+                       uint8_t * const bytes,
+                       const size_t maxBytes )
+{
+    size_t i;
+    memset( bytes, 0, maxBytes );
+    for( i = 0u; ( i < capture->numSymbols ) && ( WIRE_SYMBOL_LATCH != capture->symbols[i] ); i++ )
+    {
+        if( ( i >> 3u ) < maxBytes )
+        {
+            bytes[i >> 3u] |= (uint8_t) ( capture->symbols[i] << ( 7u - ( i & 0x07u ) ) );
+        }
+    }
+    return i;
+}
+
+/* Function:
+ *      Wire_TimingError
+ *
+ * Description:
+ *      Counts a timing violation, printing the first few.
+ */
+static void Wire_TimingError( WireCapture * const capture,
+                              const unsigned long timeNs,
+                              const char * const what,
+                              const unsigned long ns )
+{
+    if( capture->numTimingErrors < WIRE_MAX_PRINTED_ERRORS )
+    {
+        fprintf( stderr, "wire: at %lu ns, %s (%lu ns)\n", timeNs, what, ns );
+    }
+    capture->numTimingErrors++;
+    return;
+}
+
+/* Function:
+ *      Wire_TrackRange
+ *
+ * Description:
+ *      Widens a min/max pair to include a measurement.
+ */
+static void Wire_TrackRange( unsigned long * const minNs,
+                             unsigned long * const maxNs,
+                             const unsigned long ns )
+{
+    if( ns < *minNs )
+    {
+        *minNs = ns;
+    }
+    if( ns > *maxNs )
+    {
+        *maxNs = ns;
+    }
+    return;
+}
+
+/* End wire.c source file */
@@ -0,0 +1,115 @@
+/* Filename: wire.h
+ *
+ * Description: Records the level of the WS2812B data line as timestamped edges and decodes the
+ *      recording the way the led chip would: every high pulse is a 1 or 0 code by its width, and a
+ *      low time of at least the latch time is a reset. Every pulse is checked against the driver's
+ *      datasheet limits while decoding. Used by every transport test, so each of them is held to
+ *      the same decoder and the same limits.
+ *
+ */
+
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/****************** Macro Definition(s) *******************/
+#define WIRE_MAX_EDGES 16384u
+#define WIRE_MAX_SYMBOLS 8192u
+
+#define WIRE_SYMBOL_ZERO 0u
+#define WIRE_SYMBOL_ONE 1u
+#define WIRE_SYMBOL_LATCH 2u
+
+/* Initializer for a WireLimits from the timing macros in ws2812b.c. Only usable in a test that
+ * includes ws2812b.c. */
+#define WIRE_LIMITS_FROM_DRIVER \
+    { WS2812B_ONE_HIGH_NS, WS2812B_ONE_LOW_NS, WS2812B_ZERO_HIGH_NS, WS2812B_ZERO_LOW_NS, \
+      WS2812B_TOLERANCE_NS, WS2812B_MAX_LOW_NS, RESET_LOW_TIME_US * 1000ul }
+
+
+/****************** Type Definition(s) ********************/
+typedef struct
+{
+    unsigned long oneHighNs;
+    unsigned long oneLowNs;
+    unsigned long zeroHighNs;
+    unsigned long zeroLowNs;
+    unsigned long toleranceNs;
+    unsigned long maxLowNs; // Longest low time allowed inside a frame
+    unsigned long latchNs; // Shortest low time that resets the strip
+} WireLimits;
+
+typedef struct
+{
+    uint8_t symbols[WIRE_MAX_SYMBOLS]; // WIRE_SYMBOL_* in wire order
+    size_t numSymbols;
+    size_t numTimingErrors;
+
+    /* Measured extremes. The low times exclude latches and the final low of the recording. */
+    unsigned long minOneHighNs;
+    unsigned long maxOneHighNs;
+    unsigned long minZeroHighNs;
+    unsigned long maxZeroHighNs;
+    unsigned long minOneLowNs;
+    unsigned long maxOneLowNs;
+    unsigned long minZeroLowNs;
+    unsigned long maxZeroLowNs;
+
+    unsigned long firstRiseNs; // Start of the first code
+    unsigned long firstLatchNs; // Start of the low time of the first latch, 0 if there was none
+    unsigned long lastFallNs; // Start of the final low of the recording
+} WireCapture;
+
+
+/****************** Function Prototype(s) *****************/
+
+/* Function:
+ *      Wire_Clear
+ *
+ * Description:
+ *      Empties the recording. The line starts out low.
+ */
+void Wire_Clear( void );
+
+/* Function:
+ *      Wire_Drive
+ *
+ * Description:
+ *      Sets the line level at the given time. Only changes of level are recorded, and the times
+ *      must not decrease.
+ */
+void Wire_Drive( const unsigned long timeNs,
+                 const bool level );
+
+/* Function:
+ *      Wire_Decode
+ *
+ * Description:
+ *      Decodes the recording into codes and latches, checking every high and low time against the
+ *      limits. Out of range times are printed and counted in numTimingErrors. The line is assumed
+ *      to stay low after the last recorded edge.
+ */
+void Wire_Decode( const WireLimits * const limits,
+                  WireCapture * const capture );
+
+/* Function:
+ *      Wire_PackBytes
+ *
+ * Description:
+ *      Packs the codes before the first latch into bytes, MSB first, as the first pixel of the
+ *      strip would shift them in.
+ *
+ * Return:
+ *      The number of codes before the first latch. Trailing codes short of a byte are dropped
+ *      from bytes but still counted.
+ */
+size_t Wire_PackBytes( const WireCapture * const capture,
+                       uint8_t * const bytes,
+                       const size_t maxBytes );
+
+#endif
+
+/* End wire.h header file */